@@ -131,7 +131,11 @@ typedef enum {
     /* Note: if you're hunting for a flag, some day in the future when we
      * have used them all, this one is easy enough to eliminate by having the
      * tiny number of objects marked this way in a remembered set. */
-    MVM_CF_NEVER_REPOSSESS = 32
+    MVM_CF_NEVER_REPOSSESS = 32,
+
+    /* Is this the interned string for its value? Only ever set on strings,
+     * and only on ones that live in gen2 (see MVM_string_intern). */
+    MVM_CF_INTERNED_STRING = 64
 } MVMCollectableFlags1;
 
 typedef enum {
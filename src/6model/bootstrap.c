@@ -567,6 +567,7 @@ static void string_consts(MVMThreadContext *tc) {
     string_creator(positional_delegate, "positional_delegate");
     string_creator(associative_delegate, "associative_delegate");
     string_creator(auto_viv_container, "auto_viv_container");
+    string_creator(packed, "packed");
     string_creator(done, "done");
     string_creator(error, "error");
     string_creator(stdout_bytes, "stdout_bytes");
@@ -577,7 +578,9 @@ static void string_consts(MVMThreadContext *tc) {
     string_creator(stdin_fd, "stdin_fd");
     string_creator(stdin_fd_close, "stdin_fd_close");
     string_creator(stdout_fd, "stdout_fd");
+    string_creator(stdout_fd_close, "stdout_fd_close");
     string_creator(stderr_fd, "stderr_fd");
+    string_creator(stderr_fd_close, "stderr_fd_close");
     string_creator(nativeref, "nativeref");
     string_creator(refkind, "refkind");
     string_creator(positional, "positional");
@@ -289,6 +289,8 @@ void MVM_repr_initialize_registry(MVMThreadContext *tc) {
     register_core_repr(Capture);
     register_core_repr(Tracked);
     register_core_repr(Stat);
+    register_core_repr(ConcHash);
+    register_core_repr(ConcArray);
 
     assert(tc->instance->num_reprs == MVM_REPR_CORE_COUNT);
 }
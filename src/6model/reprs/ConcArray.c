@@ -0,0 +1,473 @@
+#include "moar.h"
+
+/* This representation's function pointer table. */
+static const MVMREPROps ConcArray_this_repr;
+
+/* Finds the index of the highest set bit in a non-zero value. */
+MVM_STATIC_INLINE MVMuint32 highest_bit(MVMuint64 v) {
+    MVMuint32 r = 0;
+    if (v >> 32) { v >>= 32; r += 32; }
+    if (v >> 16) { v >>= 16; r += 16; }
+    if (v >> 8)  { v >>= 8;  r += 8;  }
+    if (v >> 4)  { v >>= 4;  r += 4;  }
+    if (v >> 2)  { v >>= 2;  r += 2;  }
+    if (v >> 1)  { r += 1; }
+    return r;
+}
+
+/* Number of elements held by a segment, and the index of its first element. */
+MVM_STATIC_INLINE MVMuint64 segment_size(MVMuint32 seg) {
+    return (MVMuint64)MVM_CONC_ARRAY_FIRST_SEGMENT_SIZE << seg;
+}
+MVM_STATIC_INLINE MVMuint64 segment_start(MVMuint32 seg) {
+    return segment_size(seg) - MVM_CONC_ARRAY_FIRST_SEGMENT_SIZE;
+}
+
+/* Gets the address of the slot for an element. If its segment does not exist
+ * yet, then either allocates it (racing with any other thread doing so) or,
+ * if we are only reading, returns NULL. */
+static void * slot_for(MVMThreadContext *tc, MVMConcArrayBody *body, size_t elem_size,
+        MVMuint64 index, MVMuint32 create) {
+    MVMuint64 pos = index + MVM_CONC_ARRAY_FIRST_SEGMENT_SIZE;
+    MVMuint32 seg = highest_bit(pos) - MVM_CONC_ARRAY_FIRST_SEGMENT_BITS;
+    char *segment;
+    if (seg >= MVM_CONC_ARRAY_SEGMENTS) {
+        if (!create)
+            return NULL;
+        MVM_exception_throw_adhoc(tc, "ConcArray: Index %"PRIu64" out of range", index);
+    }
+    segment = (char *)MVM_load(&body->segments[seg]);
+    if (!segment) {
+        if (!create)
+            return NULL;
+        segment = MVM_calloc(segment_size(seg), elem_size);
+        if (!MVM_trycas(&body->segments[seg], NULL, segment)) {
+            MVM_free(segment);
+            segment = (char *)MVM_load(&body->segments[seg]);
+        }
+    }
+    return segment + (pos - segment_size(seg)) * elem_size;
+}
+
+/* Makes sure the array has at least the given number of elements. */
+static void ensure_elems(MVMConcArrayBody *body, MVMuint64 wanted) {
+    AO_t cur;
+    do {
+        cur = MVM_load(&body->elems);
+        if (cur >= wanted)
+            return;
+    } while (!MVM_trycas(&body->elems, cur, wanted));
+}
+
+/* Checks that the register kind used to access an element fits its type. */
+static void check_kind(MVMThreadContext *tc, MVMArrayREPRData *repr_data, MVMuint16 kind,
+        const char *op) {
+    switch (repr_data->slot_type) {
+        case MVM_ARRAY_OBJ:
+            if (kind != MVM_reg_obj)
+                MVM_exception_throw_adhoc(tc, "ConcArray: %s expected object register", op);
+            break;
+        case MVM_ARRAY_STR:
+            if (kind != MVM_reg_str)
+                MVM_exception_throw_adhoc(tc, "ConcArray: %s expected string register", op);
+            break;
+        case MVM_ARRAY_I64:
+        case MVM_ARRAY_I32:
+        case MVM_ARRAY_I16:
+        case MVM_ARRAY_I8:
+            if (kind != MVM_reg_int64)
+                MVM_exception_throw_adhoc(tc, "ConcArray: %s expected int register", op);
+            break;
+        case MVM_ARRAY_U64:
+        case MVM_ARRAY_U32:
+        case MVM_ARRAY_U16:
+        case MVM_ARRAY_U8:
+            if (kind != MVM_reg_uint64 && kind != MVM_reg_int64)
+                MVM_exception_throw_adhoc(tc, "ConcArray: %s expected int register", op);
+            break;
+        case MVM_ARRAY_N64:
+        case MVM_ARRAY_N32:
+            if (kind != MVM_reg_num64)
+                MVM_exception_throw_adhoc(tc, "ConcArray: %s expected num register", op);
+            break;
+        default:
+            MVM_exception_throw_adhoc(tc, "ConcArray: Unhandled slot type");
+    }
+}
+
+/* Reads an element from its slot, which may be NULL if it was never
+ * allocated. */
+static void read_slot(MVMThreadContext *tc, MVMArrayREPRData *repr_data, void *slot,
+        MVMRegister *value) {
+    switch (repr_data->slot_type) {
+        case MVM_ARRAY_OBJ: {
+            MVMObject *found = slot ? *(MVMObject **)slot : NULL;
+            value->o = found ? found : tc->instance->VMNull;
+            break;
+        }
+        case MVM_ARRAY_STR:
+            value->s = slot ? *(MVMString **)slot : NULL;
+            break;
+        case MVM_ARRAY_I64:
+            value->i64 = slot ? *(MVMint64 *)slot : 0;
+            break;
+        case MVM_ARRAY_I32:
+            value->i64 = slot ? *(MVMint32 *)slot : 0;
+            break;
+        case MVM_ARRAY_I16:
+            value->i64 = slot ? *(MVMint16 *)slot : 0;
+            break;
+        case MVM_ARRAY_I8:
+            value->i64 = slot ? *(MVMint8 *)slot : 0;
+            break;
+        case MVM_ARRAY_U64:
+            value->u64 = slot ? *(MVMuint64 *)slot : 0;
+            break;
+        case MVM_ARRAY_U32:
+            value->u64 = slot ? *(MVMuint32 *)slot : 0;
+            break;
+        case MVM_ARRAY_U16:
+            value->u64 = slot ? *(MVMuint16 *)slot : 0;
+            break;
+        case MVM_ARRAY_U8:
+            value->u64 = slot ? *(MVMuint8 *)slot : 0;
+            break;
+        case MVM_ARRAY_N64:
+            value->n64 = slot ? *(MVMnum64 *)slot : 0.0;
+            break;
+        case MVM_ARRAY_N32:
+            value->n64 = slot ? *(MVMnum32 *)slot : 0.0;
+            break;
+    }
+}
+
+/* Writes an element to its slot. */
+static void write_slot(MVMThreadContext *tc, MVMArrayREPRData *repr_data, MVMObject *root,
+        void *slot, MVMRegister value) {
+    switch (repr_data->slot_type) {
+        case MVM_ARRAY_OBJ:
+            MVM_ASSIGN_REF(tc, &(root->header), *(MVMObject **)slot, value.o);
+            break;
+        case MVM_ARRAY_STR:
+            MVM_ASSIGN_REF(tc, &(root->header), *(MVMString **)slot, value.s);
+            break;
+        case MVM_ARRAY_I64:
+            *(MVMint64 *)slot = value.i64;
+            break;
+        case MVM_ARRAY_I32:
+            *(MVMint32 *)slot = (MVMint32)value.i64;
+            break;
+        case MVM_ARRAY_I16:
+            *(MVMint16 *)slot = (MVMint16)value.i64;
+            break;
+        case MVM_ARRAY_I8:
+            *(MVMint8 *)slot = (MVMint8)value.i64;
+            break;
+        case MVM_ARRAY_U64:
+            *(MVMuint64 *)slot = value.u64;
+            break;
+        case MVM_ARRAY_U32:
+            *(MVMuint32 *)slot = (MVMuint32)value.u64;
+            break;
+        case MVM_ARRAY_U16:
+            *(MVMuint16 *)slot = (MVMuint16)value.u64;
+            break;
+        case MVM_ARRAY_U8:
+            *(MVMuint8 *)slot = (MVMuint8)value.u64;
+            break;
+        case MVM_ARRAY_N64:
+            *(MVMnum64 *)slot = value.n64;
+            break;
+        case MVM_ARRAY_N32:
+            *(MVMnum32 *)slot = (MVMnum32)value.n64;
+            break;
+    }
+}
+
+/* Creates a new type object of this representation, and associates it with
+ * the given HOW. */
+static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
+    MVMSTable *st = MVM_gc_allocate_stable(tc, &ConcArray_this_repr, HOW);
+
+    MVMROOT(tc, st) {
+        MVMObject *obj = MVM_gc_allocate_type_object(tc, st);
+        MVMArrayREPRData *repr_data = (MVMArrayREPRData *)MVM_malloc(sizeof(MVMArrayREPRData));
+
+        repr_data->slot_type = MVM_ARRAY_OBJ;
+        repr_data->elem_size = sizeof(MVMObject *);
+        repr_data->elem_type = NULL;
+
+        MVM_ASSIGN_REF(tc, &(st->header), st->WHAT, obj);
+        st->size = sizeof(MVMConcArray);
+        st->REPR_data = repr_data;
+    }
+
+    return st->WHAT;
+}
+
+/* Initializes a new instance. */
+static void initialize(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data) {
+    ((MVMConcArray *)root)->body = MVM_calloc(1, sizeof(MVMConcArrayBody));
+}
+
+/* Copies the body of one object to another. */
+static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *dest_root, void *dest) {
+    MVM_exception_throw_adhoc(tc, "Cannot copy object with representation ConcArray");
+}
+
+/* Called by the VM to mark any GCable items. */
+static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
+    /* The world is stopped, so nobody is pushing while we do this. */
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMConcArrayBody *body      = *(MVMConcArrayBody **)data;
+    MVMuint64 elems;
+    MVMuint32 seg;
+    if (!body || (repr_data->slot_type != MVM_ARRAY_OBJ && repr_data->slot_type != MVM_ARRAY_STR))
+        return;
+    elems = MVM_load(&body->elems);
+    for (seg = 0; seg < MVM_CONC_ARRAY_SEGMENTS && segment_start(seg) < elems; seg++) {
+        MVMCollectable **slots = (MVMCollectable **)body->segments[seg];
+        MVMuint64 count = elems - segment_start(seg);
+        MVMuint64 i;
+        if (!slots)
+            continue;
+        if (count > segment_size(seg))
+            count = segment_size(seg);
+        for (i = 0; i < count; i++)
+            MVM_gc_worklist_add(tc, worklist, &slots[i]);
+    }
+}
+
+/* Called by the VM in order to free memory associated with this object. */
+static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
+    MVMConcArrayBody *body = ((MVMConcArray *)obj)->body;
+    MVMuint32 seg;
+    if (!body)
+        return;
+    for (seg = 0; seg < MVM_CONC_ARRAY_SEGMENTS; seg++)
+        MVM_free(body->segments[seg]);
+    MVM_free(body);
+}
+
+/* Marks the representation data in an STable.*/
+static void gc_mark_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMGCWorklist *worklist) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    if (repr_data == NULL)
+        return;
+    MVM_gc_worklist_add(tc, worklist, &repr_data->elem_type);
+}
+
+/* Frees the representation data in an STable.*/
+static void gc_free_repr_data(MVMThreadContext *tc, MVMSTable *st) {
+    MVM_free(st->REPR_data);
+}
+
+static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMConcArrayBody *body      = *(MVMConcArrayBody **)data;
+    MVMuint64 total = sizeof(MVMConcArrayBody);
+    MVMuint32 seg;
+    for (seg = 0; seg < MVM_CONC_ARRAY_SEGMENTS; seg++)
+        if (body->segments[seg])
+            total += segment_size(seg) * repr_data->elem_size;
+    return total;
+}
+
+static const MVMStorageSpec storage_spec = {
+    MVM_STORAGE_SPEC_REFERENCE, /* inlineable */
+    0,                          /* bits */
+    0,                          /* align */
+    MVM_STORAGE_SPEC_BP_NONE,   /* boxed_primitive */
+    0,                          /* can_box */
+    0,                          /* is_unsigned */
+};
+
+/* Gets the storage specification for this representation. */
+static const MVMStorageSpec * get_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
+    return &storage_spec;
+}
+
+static void at_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMint64 index, MVMRegister *value, MVMuint16 kind) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMConcArrayBody *body      = *(MVMConcArrayBody **)data;
+    MVMuint64 elems = MVM_load(&body->elems);
+
+    check_kind(tc, repr_data, kind, "atpos");
+    if (index < 0) {
+        index += elems;
+        if (index < 0)
+            MVM_exception_throw_adhoc(tc, "ConcArray: Index out of bounds");
+    }
+    read_slot(tc, repr_data, (MVMuint64)index < elems
+        ? slot_for(tc, body, repr_data->elem_size, index, 0)
+        : NULL, value);
+}
+
+static void bind_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMint64 index, MVMRegister value, MVMuint16 kind) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMConcArrayBody *body      = *(MVMConcArrayBody **)data;
+
+    check_kind(tc, repr_data, kind, "bindpos");
+    if (index < 0) {
+        index += MVM_load(&body->elems);
+        if (index < 0)
+            MVM_exception_throw_adhoc(tc, "ConcArray: Index out of bounds");
+    }
+    write_slot(tc, repr_data, root, slot_for(tc, body, repr_data->elem_size, index, 1), value);
+    ensure_elems(body, (MVMuint64)index + 1);
+}
+
+static MVMuint64 elems(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data) {
+    MVMConcArrayBody *body = *(MVMConcArrayBody **)data;
+    return MVM_load(&body->elems);
+}
+
+/* Only growing is supported, since shrinking cannot be done safely while
+ * other threads may be writing. */
+static void set_elems(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMuint64 count) {
+    MVMConcArrayBody *body = *(MVMConcArrayBody **)data;
+    if (count < MVM_load(&body->elems))
+        MVM_exception_throw_adhoc(tc, "ConcArray: Cannot reduce the number of elements");
+    ensure_elems(body, count);
+}
+
+static void push(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMRegister value, MVMuint16 kind) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMConcArrayBody *body      = *(MVMConcArrayBody **)data;
+    MVMuint64 index;
+
+    check_kind(tc, repr_data, kind, "push");
+    index = MVM_incr(&body->elems);
+    write_slot(tc, repr_data, root, slot_for(tc, body, repr_data->elem_size, index, 1), value);
+}
+
+static AO_t * pos_as_atomic(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
+                            void *data, MVMint64 index) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVMConcArrayBody *body      = *(MVMConcArrayBody **)data;
+    MVMuint64 elems = MVM_load(&body->elems);
+
+    /* Handle negative indexes and require in bounds. */
+    if (index < 0)
+        index += elems;
+    if (index < 0 || (MVMuint64)index >= elems)
+        MVM_exception_throw_adhoc(tc, "Index out of bounds in atomic operation on array");
+
+    if ((sizeof(AO_t) == 8 && (repr_data->slot_type == MVM_ARRAY_I64 ||
+            repr_data->slot_type == MVM_ARRAY_U64)) ||
+        (sizeof(AO_t) == 4 && (repr_data->slot_type == MVM_ARRAY_I32 ||
+            repr_data->slot_type == MVM_ARRAY_U32)))
+        return (AO_t *)slot_for(tc, body, repr_data->elem_size, index, 1);
+    MVM_exception_throw_adhoc(tc,
+        "Can only do integer atomic operation on native integer array element of atomic size");
+}
+
+static AO_t * pos_as_atomic_multidim(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
+                                     void *data, MVMint64 num_indices, MVMint64 *indices) {
+    if (num_indices != 1)
+        MVM_exception_throw_adhoc(tc,
+            "A dynamic array can only be indexed with a single dimension");
+    return pos_as_atomic(tc, st, root, data, indices[0]);
+}
+
+/* Compose the representation. */
+static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
+    MVMStringConsts         str_consts = tc->instance->str_consts;
+    MVMArrayREPRData * const repr_data = (MVMArrayREPRData *)st->REPR_data;
+
+    MVMObject *info = MVM_repr_at_key_o(tc, info_hash, str_consts.array);
+    if (!MVM_is_null(tc, info)) {
+        MVMObject *type = MVM_repr_at_key_o(tc, info, str_consts.type);
+        if (!MVM_is_null(tc, type)) {
+            const MVMStorageSpec *spec = REPR(type)->get_storage_spec(tc, STABLE(type));
+            MVM_ASSIGN_REF(tc, &(st->header), repr_data->elem_type, type);
+            MVM_VMArray_spec_to_repr_data(tc, repr_data, spec);
+            if (repr_data->elem_size == 0)
+                MVM_exception_throw_adhoc(tc,
+                    "ConcArray: Sub-byte element types are not supported");
+        }
+    }
+}
+
+/* Set the size of the STable. */
+static void deserialize_stable_size(MVMThreadContext *tc, MVMSTable *st, MVMSerializationReader *reader) {
+    st->size = sizeof(MVMConcArray);
+}
+
+/* Serializes the REPR data. */
+static void serialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializationWriter *writer) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
+    MVM_serialization_write_ref(tc, writer, repr_data->elem_type);
+}
+
+/* Deserializes representation data. */
+static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializationReader *reader) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)MVM_malloc(sizeof(MVMArrayREPRData));
+
+    MVMObject *type = MVM_serialization_read_ref(tc, reader);
+    MVM_ASSIGN_REF(tc, &(st->header), repr_data->elem_type, type);
+    repr_data->slot_type = MVM_ARRAY_OBJ;
+    repr_data->elem_size = sizeof(MVMObject *);
+    st->REPR_data = repr_data;
+
+    if (type) {
+        const MVMStorageSpec *spec;
+        MVM_serialization_force_stable(tc, reader, STABLE(type));
+        spec = REPR(type)->get_storage_spec(tc, STABLE(type));
+        MVM_VMArray_spec_to_repr_data(tc, repr_data, spec);
+    }
+}
+
+/* Initializes the representation. */
+const MVMREPROps * MVMConcArray_initialize(MVMThreadContext *tc) {
+    return &ConcArray_this_repr;
+}
+
+static const MVMREPROps ConcArray_this_repr = {
+    type_object_for,
+    MVM_gc_allocate_object,
+    initialize,
+    copy_to,
+    MVM_REPR_DEFAULT_ATTR_FUNCS,
+    MVM_REPR_DEFAULT_BOX_FUNCS,
+    {
+        at_pos,
+        bind_pos,
+        set_elems,
+        push,
+        MVM_REPR_DEFAULT_POP,
+        MVM_REPR_DEFAULT_UNSHIFT,
+        MVM_REPR_DEFAULT_SHIFT,
+        MVM_REPR_DEFAULT_SLICE,
+        MVM_REPR_DEFAULT_SPLICE,
+        MVM_REPR_DEFAULT_AT_POS_MULTIDIM,
+        MVM_REPR_DEFAULT_BIND_POS_MULTIDIM,
+        MVM_REPR_DEFAULT_DIMENSIONS,
+        MVM_REPR_DEFAULT_SET_DIMENSIONS,
+        MVM_VMArray_get_elem_storage_spec,
+        pos_as_atomic,
+        pos_as_atomic_multidim,
+        MVM_REPR_DEFAULT_POS_WRITE_BUF,
+        MVM_REPR_DEFAULT_POS_READ_BUF
+    },    /* pos_funcs */
+    MVM_REPR_DEFAULT_ASS_FUNCS,
+    elems,
+    get_storage_spec,
+    NULL, /* change_type */
+    NULL, /* serialize */
+    NULL, /* deserialize */
+    serialize_repr_data,
+    deserialize_repr_data,
+    deserialize_stable_size,
+    gc_mark,
+    gc_free,
+    NULL, /* gc_cleanup */
+    gc_mark_repr_data,
+    gc_free_repr_data,
+    compose,
+    NULL, /* spesh */
+    "ConcArray", /* name */
+    MVM_REPR_ID_ConcArray,
+    unmanaged_size,
+    NULL /* describe_refs */
+};
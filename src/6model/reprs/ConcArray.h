@@ -0,0 +1,33 @@
+/* The first segment of a concurrent array holds this many elements, and each
+ * following one twice as many as the one before it. */
+#define MVM_CONC_ARRAY_FIRST_SEGMENT_BITS 4
+#define MVM_CONC_ARRAY_FIRST_SEGMENT_SIZE (1 << MVM_CONC_ARRAY_FIRST_SEGMENT_BITS)
+
+/* The most segments a concurrent array may have. */
+#define MVM_CONC_ARRAY_SEGMENTS 40
+
+/* Representation used for arrays that many threads may push to and index
+ * into at once. Storage is split into segments of growing size, which are
+ * allocated on first use and never moved or resized, so growing the array
+ * never disturbs a concurrent reader, and a push only has to atomically
+ * claim an index. Element types are as for VMArray (and REPR data is the
+ * same MVMArrayREPRData), except that the sub-byte ones are not supported.
+ *
+ * An element that has been claimed but not yet written reads as a null or
+ * zero value. The body is allocated by malloc(), as with the other REPRs
+ * intended for concurrent use. */
+struct MVMConcArrayBody {
+    /* Number of elements claimed so far. */
+    AO_t elems;
+
+    /* The segments; NULL until first used. */
+    void *segments[MVM_CONC_ARRAY_SEGMENTS];
+};
+
+struct MVMConcArray {
+    MVMObject common;
+    MVMConcArrayBody *body;
+};
+
+/* Function for REPR setup. */
+const MVMREPROps * MVMConcArray_initialize(MVMThreadContext *tc);
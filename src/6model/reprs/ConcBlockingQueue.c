@@ -3,6 +3,54 @@
 /* This representation's function pointer table. */
 static const MVMREPROps ConcBlockingQueue_this_repr;
 
+/* The most nodes we keep around for reuse in a single queue. */
+#define MVM_CBQ_MAX_FREE_NODES 256
+
+/* Gets a node to add to the queue, reusing a free one if possible. Must be
+ * called with the tail lock held, which makes this the only thread taking
+ * nodes from the free list. */
+static MVMConcBlockingQueueNode * take_node(MVMConcBlockingQueueBody *body) {
+    MVMConcBlockingQueueNode *node;
+    while ((node = (MVMConcBlockingQueueNode *)MVM_load(&body->free_nodes))) {
+        if (MVM_trycas(&body->free_nodes, node, node->next)) {
+            MVM_decr(&body->num_free_nodes);
+            node->next = NULL;
+            return node;
+        }
+    }
+    return MVM_calloc(1, sizeof(MVMConcBlockingQueueNode));
+}
+
+/* Puts a node that is no longer part of the queue on the free list, or frees
+ * it if we already have plenty. */
+static void release_node(MVMConcBlockingQueueBody *body, MVMConcBlockingQueueNode *node) {
+    MVMConcBlockingQueueNode *head;
+    if (MVM_load(&body->num_free_nodes) >= MVM_CBQ_MAX_FREE_NODES) {
+        MVM_free(node);
+        return;
+    }
+    MVM_incr(&body->num_free_nodes);
+    do {
+        head = (MVMConcBlockingQueueNode *)MVM_load(&body->free_nodes);
+        node->next = head;
+    } while (!MVM_trycas(&body->free_nodes, head, node));
+}
+
+/* Takes the value at the head of the queue. Must be called with the head lock
+ * held and only once the queue is known to have an element. The element count
+ * is left for the caller to update. */
+static MVMObject * take_head(MVMConcBlockingQueueBody *body) {
+    MVMConcBlockingQueueNode *taken = body->head->next;
+    MVMObject *value;
+    release_node(body, body->head);
+    body->head = taken;
+    MVM_barrier();
+    value = taken->value;
+    taken->value = NULL;
+    MVM_barrier();
+    return value;
+}
+
 /* Creates a new type object of this representation, and associates it with
  * the given HOW. */
 static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
@@ -58,7 +106,8 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
 
 static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
     MVMConcBlockingQueueBody *cbq = *(MVMConcBlockingQueueBody **)data;
-    MVMuint64 total = MVM_load(&cbq->elems) * sizeof(MVMConcBlockingQueueNode);
+    MVMuint64 total = (MVM_load(&cbq->elems) + MVM_load(&cbq->num_free_nodes))
+        * sizeof(MVMConcBlockingQueueNode);
     return total;
 }
 
@@ -75,6 +124,13 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
         cur = next;
     }
     body->head = body->tail = NULL;
+    cur = body->free_nodes;
+    while (cur) {
+        MVMConcBlockingQueueNode *next = cur->next;
+        MVM_free(cur);
+        cur = next;
+    }
+    body->free_nodes = NULL;
 
     /* Clean up  */
     uv_mutex_destroy(&body->head_lock);
@@ -152,21 +208,23 @@ static void push(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *dat
         MVM_exception_throw_adhoc(tc,
             "Cannot store a null value in a concurrent blocking queue");
 
-    add = MVM_calloc(1, sizeof(MVMConcBlockingQueueNode));
-
     interval_id = MVM_telemetry_interval_start(tc, "ConcBlockingQueue.push");
     MVMROOT2(tc, root, to_add) {
         MVM_gc_mark_thread_blocked(tc);
         uv_mutex_lock(&body->tail_lock);
         MVM_gc_mark_thread_unblocked(tc);
     }
+    add = take_node(body);
     MVM_ASSIGN_REF(tc, &(root->header), add->value, to_add);
     body->tail->next = add;
     body->tail = add;
     orig_elems = MVM_incr(&body->elems);
     uv_mutex_unlock(&body->tail_lock);
 
-    if (orig_elems == 0) {
+    /* Only take the head lock to wake a thread if one is waiting. Since both
+     * the element count and waiter count updates are full barriers, either we
+     * see the waiter or it sees the element. */
+    if (MVM_load(&body->waiters) > 0) {
         MVMROOT(tc, root) {
             MVM_gc_mark_thread_blocked(tc);
             uv_mutex_lock(&body->head_lock);
@@ -197,8 +255,6 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
 
     interval_id = MVM_telemetry_interval_start(tc, "ConcBlockingQueue.unshift");
 
-    add = MVM_calloc(1, sizeof(MVMConcBlockingQueueNode));
-
     /* We'll need to hold both the head and the tail lock, in case head == tail
      * and push would update tail->next - without the tail lock, this could
      * race. Ensure that we lock in the same order */
@@ -209,6 +265,7 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
         MVM_gc_mark_thread_unblocked(tc);
     }
 
+    add = take_node(cbq);
     MVM_ASSIGN_REF(tc, &(root->header), add->value, to_add);
     add->next = cbq->head->next;
     cbq->head->next = add;
@@ -229,7 +286,6 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
 
 static void shift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMRegister *value, MVMuint16 kind) {
     MVMConcBlockingQueueBody *body = *(MVMConcBlockingQueueBody**)data;
-    MVMConcBlockingQueueNode *taken;
     unsigned int interval_id;
 
     if (kind != MVM_reg_obj)
@@ -241,20 +297,18 @@ static void shift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *da
         uv_mutex_lock(&body->head_lock);
         MVM_gc_mark_thread_unblocked(tc);
 
-        while (MVM_load(&body->elems) == 0) {
+        if (MVM_load(&body->elems) == 0) {
+            MVM_incr(&body->waiters);
+            while (MVM_load(&body->elems) == 0) {
                 MVM_gc_mark_thread_blocked(tc);
                 uv_cond_wait(&body->head_cond, &body->head_lock);
                 MVM_gc_mark_thread_unblocked(tc);
+            }
+            MVM_decr(&body->waiters);
         }
     }
 
-    taken = body->head->next;
-    MVM_free(body->head);
-    body->head = taken;
-    MVM_barrier();
-    value->o = taken->value;
-    taken->value = NULL;
-    MVM_barrier();
+    value->o = take_head(body);
 
     if (MVM_decr(&body->elems) > 1)
         uv_cond_signal(&body->head_cond);
@@ -334,10 +388,14 @@ MVMObject * MVM_concblockingqueue_jit_poll(MVMThreadContext *tc, MVMObject *queu
 MVMObject * MVM_concblockingqueue_poll(MVMThreadContext *tc, MVMConcBlockingQueue *queue) {
     MVMConcBlockingQueue *cbq = (MVMConcBlockingQueue *)queue;
     MVMConcBlockingQueueBody *body = cbq->body;
-    MVMConcBlockingQueueNode *taken;
     MVMObject *result = tc->instance->VMNull;
     unsigned int interval_id;
 
+    /* Polling an empty queue is very common (for example, the event loop
+     * checking for new work), so answer that without taking the lock. */
+    if (MVM_load(&body->elems) == 0)
+        return result;
+
     interval_id = MVM_telemetry_interval_start(tc, "ConcBlockingQueue.poll");
     MVMROOT(tc, cbq) { /* No need to root result as VMNull is always in gen2 */
         MVM_gc_mark_thread_blocked(tc);
@@ -346,13 +404,7 @@ MVMObject * MVM_concblockingqueue_poll(MVMThreadContext *tc, MVMConcBlockingQueu
     }
 
     if (MVM_load(&body->elems) > 0) {
-        taken = body->head->next;
-        MVM_free(body->head);
-        body->head = taken;
-        MVM_barrier();
-        result = taken->value;
-        taken->value = NULL;
-        MVM_barrier();
+        result = take_head(body);
         if (MVM_decr(&body->elems) > 1)
             uv_cond_signal(&body->head_cond);
     }
@@ -362,3 +414,39 @@ MVMObject * MVM_concblockingqueue_poll(MVMThreadContext *tc, MVMConcBlockingQueu
     MVM_telemetry_interval_stop((MVMThreadContext *)result, interval_id, "ConcBlockingQueue.poll result");
     return result;
 }
+
+/* Polls a queue for up to max values, returning them in a new array, which is
+ * empty if there were none available. All values are taken while holding the
+ * lock only once. */
+MVMObject * MVM_concblockingqueue_poll_batch(MVMThreadContext *tc, MVMConcBlockingQueue *queue,
+        MVMint64 max) {
+    MVMConcBlockingQueueBody *body = queue->body;
+    MVMObject *result = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+    MVMint64 wanted = MVM_load(&body->elems);
+    MVMint64 taken = 0;
+    if (wanted > max)
+        wanted = max;
+    if (wanted <= 0)
+        return result;
+
+    /* Make room up front, so that we do not allocate with the lock held. */
+    MVMROOT2(tc, queue, result) {
+        MVM_repr_pos_set_elems(tc, result, wanted);
+        MVM_gc_mark_thread_blocked(tc);
+        uv_mutex_lock(&body->head_lock);
+        MVM_gc_mark_thread_unblocked(tc);
+    }
+
+    while (taken < wanted && MVM_load(&body->elems) > 0) {
+        MVM_repr_bind_pos_o(tc, result, taken++, take_head(body));
+        MVM_decr(&body->elems);
+    }
+    if (MVM_load(&body->elems) > 0)
+        uv_cond_signal(&body->head_cond);
+
+    uv_mutex_unlock(&body->head_lock);
+
+    if (taken < wanted)
+        MVM_repr_pos_set_elems(tc, result, taken);
+    return result;
+}
@@ -18,6 +18,16 @@ struct MVMConcBlockingQueueBody {
     /* Number of elements currently in the queue. */
     AO_t elems;
 
+    /* Number of threads blocked in shift waiting for an element. Pushers only
+     * need to take the head lock to wake someone when this is non-zero. */
+    AO_t waiters;
+
+    /* Nodes no longer in use, kept for reuse by later pushes. Nodes are only
+     * taken from this list with the tail lock held, so there is only ever a
+     * single popper and the lock-free stack is not subject to ABA. */
+    MVMConcBlockingQueueNode *free_nodes;
+    AO_t num_free_nodes;
+
     /* Locks and condition variables storage. */
     uv_mutex_t  head_lock;
     uv_mutex_t  tail_lock;
@@ -35,6 +45,8 @@ const MVMREPROps * MVMConcBlockingQueue_initialize(MVMThreadContext *tc);
 
 /* Operations on concurrent blocking queues. */
 MVMObject * MVM_concblockingqueue_poll(MVMThreadContext *tc, MVMConcBlockingQueue *queue);
+MVMObject * MVM_concblockingqueue_poll_batch(MVMThreadContext *tc, MVMConcBlockingQueue *queue,
+    MVMint64 max);
 
 /* Purely for the convenience of the jit */
 MVMObject * MVM_concblockingqueue_jit_poll(MVMThreadContext *tc, MVMObject *queue);
@@ -0,0 +1,329 @@
+#include "moar.h"
+
+/* This representation's function pointer table. */
+static const MVMREPROps ConcHash_this_repr;
+
+/* Locates the stripe that a key belongs in. */
+MVM_STATIC_INLINE MVMConcHashStripe * stripe_for(MVMThreadContext *tc, MVMConcHashBody *body,
+        MVMString *key) {
+    return &(body->stripes[MVM_string_hash_code(tc, key) & (MVM_CONC_HASH_STRIPES - 1)]);
+}
+
+/* Nothing done while holding a stripe lock can allocate or otherwise reach a
+ * GC safepoint, so the locks are held only briefly and we need not mark the
+ * thread blocked while acquiring them. */
+MVM_STATIC_INLINE void read_lock(MVMConcHashStripe *stripe) {
+    uv_rwlock_rdlock(&stripe->lock);
+}
+MVM_STATIC_INLINE void read_unlock(MVMConcHashStripe *stripe) {
+    uv_rwlock_rdunlock(&stripe->lock);
+}
+MVM_STATIC_INLINE void write_lock(MVMConcHashStripe *stripe) {
+    uv_rwlock_wrlock(&stripe->lock);
+}
+MVM_STATIC_INLINE void write_unlock(MVMConcHashStripe *stripe) {
+    uv_rwlock_wrunlock(&stripe->lock);
+}
+
+/* Looks up the entry for a key in a stripe, which must be locked for writing,
+ * creating it if needed. A freshly created entry has its value set to NULL. */
+static MVMHashEntry * lvalue_fetch(MVMThreadContext *tc, MVMObject *root,
+        MVMConcHashStripe *stripe, MVMString *key) {
+    MVMStrHashTable *hashtable = &(stripe->hashtable);
+    MVMHashEntry *entry;
+    if (!MVM_str_hash_entry_size(tc, hashtable))
+        MVM_str_hash_build(tc, hashtable, sizeof(MVMHashEntry), 0);
+    entry = MVM_str_hash_lvalue_fetch_nocheck(tc, hashtable, key);
+    if (!entry->hash_handle.key) {
+        entry->hash_handle.key = key;
+        entry->value = NULL;
+        MVM_gc_write_barrier(tc, &(root->header), &(key->common.header));
+    }
+    return entry;
+}
+
+/* Creates a new type object of this representation, and associates it with
+ * the given HOW. */
+static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
+    MVMSTable *st  = MVM_gc_allocate_stable(tc, &ConcHash_this_repr, HOW);
+
+    MVMROOT(tc, st) {
+        MVMObject *obj = MVM_gc_allocate_type_object(tc, st);
+        MVM_ASSIGN_REF(tc, &(st->header), st->WHAT, obj);
+        st->size = sizeof(MVMConcHash);
+    }
+
+    return st->WHAT;
+}
+
+/* Initializes a new instance. */
+static void initialize(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data) {
+    MVMConcHashBody *body = MVM_calloc(1, sizeof(MVMConcHashBody));
+    MVMuint32 i;
+    int init_stat;
+    for (i = 0; i < MVM_CONC_HASH_STRIPES; i++) {
+        if ((init_stat = uv_rwlock_init(&body->stripes[i].lock)) < 0) {
+            while (i--)
+                uv_rwlock_destroy(&body->stripes[i].lock);
+            MVM_free(body);
+            MVM_exception_throw_adhoc(tc, "Failed to initialize read/write lock: %s",
+                uv_strerror(init_stat));
+        }
+    }
+    ((MVMConcHash *)root)->body = body;
+}
+
+/* Copies the body of one object to another. */
+static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *dest_root, void *dest) {
+    MVM_exception_throw_adhoc(tc, "Cannot copy object with representation ConcHash");
+}
+
+/* Called by the VM to mark any GCable items. */
+static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
+    /* The world is stopped, so no locking is needed. */
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMuint32 i;
+    if (!body)
+        return;
+    for (i = 0; i < MVM_CONC_HASH_STRIPES; i++) {
+        MVMStrHashTable *hashtable = &(body->stripes[i].hashtable);
+        MVMStrHashIterator iterator;
+        if (MVM_str_hash_is_empty(tc, hashtable))
+            continue;
+        iterator = MVM_str_hash_first(tc, hashtable);
+        while (!MVM_str_hash_at_end(tc, hashtable, iterator)) {
+            MVMHashEntry *current = MVM_str_hash_current_nocheck(tc, hashtable, iterator);
+            MVM_gc_worklist_add(tc, worklist, &current->hash_handle.key);
+            MVM_gc_worklist_add(tc, worklist, &current->value);
+            iterator = MVM_str_hash_next_nocheck(tc, hashtable, iterator);
+        }
+    }
+}
+
+/* Called by the VM in order to free memory associated with this object. */
+static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
+    MVMConcHashBody *body = ((MVMConcHash *)obj)->body;
+    MVMuint32 i;
+    if (!body)
+        return;
+    for (i = 0; i < MVM_CONC_HASH_STRIPES; i++) {
+        MVM_str_hash_demolish(tc, &(body->stripes[i].hashtable));
+        uv_rwlock_destroy(&body->stripes[i].lock);
+    }
+    MVM_free(body);
+}
+
+static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMuint64 total = sizeof(MVMConcHashBody);
+    MVMuint32 i;
+    for (i = 0; i < MVM_CONC_HASH_STRIPES; i++)
+        total += MVM_str_hash_allocated_size(tc, &(body->stripes[i].hashtable));
+    return total;
+}
+
+static void at_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key_obj, MVMRegister *result, MVMuint16 kind) {
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMString *key = (MVMString *)key_obj;
+    MVMConcHashStripe *stripe;
+    MVMHashEntry *entry;
+
+    if (!MVM_str_hash_key_is_valid(tc, key))
+        MVM_str_hash_key_throw_invalid(tc, key);
+    if (MVM_UNLIKELY(kind != MVM_reg_obj))
+        MVM_exception_throw_adhoc(tc,
+            "ConcHash representation does not support native type storage");
+
+    stripe = stripe_for(tc, body, key);
+    read_lock(stripe);
+    entry = MVM_str_hash_fetch_nocheck(tc, &(stripe->hashtable), key);
+    result->o = entry != NULL ? entry->value : tc->instance->VMNull;
+    read_unlock(stripe);
+}
+
+static void bind_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key_obj, MVMRegister value, MVMuint16 kind) {
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMString *key = (MVMString *)key_obj;
+    MVMConcHashStripe *stripe;
+    MVMHashEntry *entry;
+
+    if (!MVM_str_hash_key_is_valid(tc, key))
+        MVM_str_hash_key_throw_invalid(tc, key);
+    if (MVM_UNLIKELY(kind != MVM_reg_obj))
+        MVM_exception_throw_adhoc(tc,
+            "ConcHash representation does not support native type storage");
+
+    stripe = stripe_for(tc, body, key);
+    write_lock(stripe);
+    entry = lvalue_fetch(tc, root, stripe, key);
+    MVM_ASSIGN_REF(tc, &(root->header), entry->value, value.o);
+    write_unlock(stripe);
+}
+
+static MVMint64 exists_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key_obj) {
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMString *key = (MVMString *)key_obj;
+    MVMConcHashStripe *stripe;
+    MVMint64 result;
+
+    if (!MVM_str_hash_key_is_valid(tc, key))
+        MVM_str_hash_key_throw_invalid(tc, key);
+
+    stripe = stripe_for(tc, body, key);
+    read_lock(stripe);
+    result = MVM_str_hash_fetch_nocheck(tc, &(stripe->hashtable), key) != NULL;
+    read_unlock(stripe);
+    return result;
+}
+
+static void delete_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key_obj) {
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMString *key = (MVMString *)key_obj;
+    MVMConcHashStripe *stripe;
+
+    if (!MVM_str_hash_key_is_valid(tc, key))
+        MVM_str_hash_key_throw_invalid(tc, key);
+
+    stripe = stripe_for(tc, body, key);
+    write_lock(stripe);
+    MVM_str_hash_delete_nocheck(tc, &(stripe->hashtable), key);
+    write_unlock(stripe);
+}
+
+static MVMStorageSpec get_value_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
+    MVMStorageSpec spec;
+    spec.inlineable      = MVM_STORAGE_SPEC_REFERENCE;
+    spec.boxed_primitive = MVM_STORAGE_SPEC_BP_NONE;
+    spec.can_box         = 0;
+    spec.bits            = 0;
+    spec.align           = 0;
+    spec.is_unsigned     = 0;
+    return spec;
+}
+
+/* Counts the elements. Other threads may be adding or removing keys while we
+ * do so, so this is only a snapshot. */
+static MVMuint64 elems(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data) {
+    MVMConcHashBody *body = *(MVMConcHashBody **)data;
+    MVMuint64 total = 0;
+    MVMuint32 i;
+    for (i = 0; i < MVM_CONC_HASH_STRIPES; i++) {
+        MVMConcHashStripe *stripe = &(body->stripes[i]);
+        read_lock(stripe);
+        total += MVM_str_hash_count(tc, &(stripe->hashtable));
+        read_unlock(stripe);
+    }
+    return total;
+}
+
+static const MVMStorageSpec storage_spec = {
+    MVM_STORAGE_SPEC_REFERENCE, /* inlineable */
+    0,                          /* bits */
+    0,                          /* align */
+    MVM_STORAGE_SPEC_BP_NONE,   /* boxed_primitive */
+    0,                          /* can_box */
+    0,                          /* is_unsigned */
+};
+
+/* Gets the storage specification for this representation. */
+static const MVMStorageSpec * get_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
+    return &storage_spec;
+}
+
+/* Compose the representation. */
+static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info) {
+    /* Nothing to do for this REPR. */
+}
+
+/* Set the size of the STable. */
+static void deserialize_stable_size(MVMThreadContext *tc, MVMSTable *st, MVMSerializationReader *reader) {
+    st->size = sizeof(MVMConcHash);
+}
+
+/* Initializes the representation. */
+const MVMREPROps * MVMConcHash_initialize(MVMThreadContext *tc) {
+    return &ConcHash_this_repr;
+}
+
+static const MVMREPROps ConcHash_this_repr = {
+    type_object_for,
+    MVM_gc_allocate_object,
+    initialize,
+    copy_to,
+    MVM_REPR_DEFAULT_ATTR_FUNCS,
+    MVM_REPR_DEFAULT_BOX_FUNCS,
+    MVM_REPR_DEFAULT_POS_FUNCS,
+    {
+        at_key,
+        bind_key,
+        exists_key,
+        delete_key,
+        get_value_storage_spec
+    },    /* ass_funcs */
+    elems,
+    get_storage_spec,
+    NULL, /* change_type */
+    NULL, /* serialize */
+    NULL, /* deserialize */
+    NULL, /* serialize_repr_data */
+    NULL, /* deserialize_repr_data */
+    deserialize_stable_size,
+    gc_mark,
+    gc_free,
+    NULL, /* gc_cleanup */
+    NULL, /* gc_mark_repr_data */
+    NULL, /* gc_free_repr_data */
+    compose,
+    NULL, /* spesh */
+    "ConcHash", /* name */
+    MVM_REPR_ID_ConcHash,
+    unmanaged_size,
+    NULL /* describe_refs */
+};
+
+/* Binds a value to a key only if the key is not already present. Returns the
+ * value that the key maps to afterwards: either the existing one, or the one
+ * that was just bound. */
+MVMObject * MVM_conc_hash_bind_if_absent(MVMThreadContext *tc, MVMObject *hash,
+        MVMString *key, MVMObject *value) {
+    MVMConcHashStripe *stripe;
+    MVMHashEntry *entry;
+    MVMObject *result;
+
+    if (!MVM_str_hash_key_is_valid(tc, key))
+        MVM_str_hash_key_throw_invalid(tc, key);
+
+    stripe = stripe_for(tc, ((MVMConcHash *)hash)->body, key);
+    write_lock(stripe);
+    entry = lvalue_fetch(tc, hash, stripe, key);
+    if (!entry->value)
+        MVM_ASSIGN_REF(tc, &(hash->header), entry->value, value);
+    result = entry->value;
+    write_unlock(stripe);
+    return result;
+}
+
+/* Binds a value to a key only if the key currently maps to the expected value;
+ * a missing key is treated as mapping to VMNull. Returns the value that was
+ * seen, so the caller knows they succeeded if it is the expected one. */
+MVMObject * MVM_conc_hash_cas(MVMThreadContext *tc, MVMObject *hash, MVMString *key,
+        MVMObject *expected, MVMObject *value) {
+    MVMConcHashStripe *stripe;
+    MVMHashEntry *entry;
+    MVMObject *seen;
+
+    if (!MVM_str_hash_key_is_valid(tc, key))
+        MVM_str_hash_key_throw_invalid(tc, key);
+
+    stripe = stripe_for(tc, ((MVMConcHash *)hash)->body, key);
+    write_lock(stripe);
+    entry = MVM_str_hash_fetch_nocheck(tc, &(stripe->hashtable), key);
+    seen = entry != NULL ? entry->value : tc->instance->VMNull;
+    if (seen == expected) {
+        if (!entry)
+            entry = lvalue_fetch(tc, hash, stripe, key);
+        MVM_ASSIGN_REF(tc, &(hash->header), entry->value, value);
+    }
+    write_unlock(stripe);
+    return seen;
+}
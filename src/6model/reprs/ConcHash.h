@@ -0,0 +1,33 @@
+/* Number of independently locked parts a concurrent hash is split into. Must
+ * be a power of two. */
+#define MVM_CONC_HASH_STRIPES 16
+
+/* A single stripe of a concurrent hash: a string hash table of MVMHashEntry
+ * along with the lock that protects it. Lookups take the lock for reading,
+ * so they can proceed in parallel. */
+struct MVMConcHashStripe {
+    uv_rwlock_t     lock;
+    MVMStrHashTable hashtable;
+};
+
+/* Representation used for concurrent hashes. Keys are spread over the stripes
+ * by their hash code, so writers to different stripes do not contend. As with
+ * ConcBlockingQueue, the body is allocated by malloc() rather than the GC so
+ * that the locks never move. */
+struct MVMConcHashBody {
+    MVMConcHashStripe stripes[MVM_CONC_HASH_STRIPES];
+};
+
+struct MVMConcHash {
+    MVMObject common;
+    MVMConcHashBody *body;
+};
+
+/* Function for REPR setup. */
+const MVMREPROps * MVMConcHash_initialize(MVMThreadContext *tc);
+
+/* Atomic operations on concurrent hashes. */
+MVMObject * MVM_conc_hash_bind_if_absent(MVMThreadContext *tc, MVMObject *hash,
+    MVMString *key, MVMObject *value);
+MVMObject * MVM_conc_hash_cas(MVMThreadContext *tc, MVMObject *hash, MVMString *key,
+    MVMObject *expected, MVMObject *value);
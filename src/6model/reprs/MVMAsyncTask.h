@@ -23,6 +23,10 @@ struct MVMAsyncTaskBody {
     /* The cancellation notification handler, if any. */
     MVMObject *cancel_notify_schedulee;
 
+    /* The event loop the task is pinned to; NULL until it is first sent to
+     * one. */
+    MVMEventLoop *loop;
+
     /* The current state of the task. */
     MVMint32 state;
 };
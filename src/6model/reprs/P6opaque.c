@@ -714,6 +714,113 @@ static MVMuint16 * allocate_unbox_slots(void) {
         slots[i] = MVM_P6OPAQUE_NO_UNBOX_SLOT;
     return slots;
 }
+
+/* Works out the packed layout. The attributes of each class in the MRO still
+ * follow those of the classes before it, so that a mixin type keeps the
+ * layout of the type it is derived from. But within each class, reference
+ * typed attributes come first, all together, followed by the flattened ones
+ * in order of decreasing alignment, which leaves a minimum of padding. The
+ * classes are given by their attribute counts, least derived first. Stores
+ * the offset of each attribute into offsets, unless that is NULL, and returns
+ * the offset just past the last of them. */
+static MVMuint64 packed_layout(MVMThreadContext *tc, MVMuint16 num_attributes,
+        MVMSTable **flattened_stables, MVMuint16 num_classes, MVMuint16 *class_attrs,
+        MVMuint16 *offsets) {
+    MVMuint16 *order      = MVM_malloc(P6OMAX(num_attributes, 1) * sizeof(MVMuint16));
+    MVMuint32 *ranks      = MVM_malloc(P6OMAX(num_attributes, 1) * sizeof(MVMuint32));
+    MVMuint64  cur_offset = sizeof(MVMP6opaqueBody);
+    MVMuint16  first      = 0;
+    MVMuint16  c, i, j;
+
+    /* Rank flattened attributes by alignment, and references above them. */
+    for (i = 0; i < num_attributes; i++) {
+        MVMSTable *flat_st = flattened_stables[i];
+        if (flat_st) {
+            ranks[i] = flat_st->REPR->get_storage_spec(tc, flat_st)->align;
+            if (ranks[i] == 0) {
+                MVM_free(order);
+                MVM_free(ranks);
+                MVM_exception_throw_adhoc(tc, "P6opaque: Storage Spec of flattened attribute must not have align set to 0");
+            }
+        }
+        else {
+            ranks[i] = UINT32_MAX;
+        }
+    }
+
+    for (c = 0; c < num_classes; c++) {
+        MVMuint16 end = first + class_attrs[c];
+
+        /* Insertion sort the slots of this class by rank; classes have few
+         * attributes, and it keeps declaration order among equals. */
+        for (i = first; i < end; i++) {
+            for (j = i; j > first && ranks[order[j - 1]] < ranks[i]; j--)
+                order[j] = order[j - 1];
+            order[j] = i;
+        }
+
+        for (i = first; i < end; i++) {
+            MVMuint16  slot    = order[i];
+            MVMSTable *flat_st = flattened_stables[slot];
+            if (flat_st) {
+                const MVMStorageSpec *spec = flat_st->REPR->get_storage_spec(tc, flat_st);
+                align_to(&cur_offset, spec->align);
+                if (offsets)
+                    offsets[slot] = cur_offset;
+                cur_offset += spec->bits / 8;
+            }
+            else {
+                align_to(&cur_offset, ALIGNOF(MVMObject *));
+                if (offsets)
+                    offsets[slot] = cur_offset;
+                cur_offset += sizeof(MVMObject *);
+            }
+        }
+
+        first = end;
+    }
+
+    MVM_free(order);
+    MVM_free(ranks);
+    return cur_offset;
+}
+
+/* Replaces the declaration order layout of the attributes by the packed one,
+ * returning the offset just past the last attribute. */
+static MVMuint64 apply_packed_layout(MVMThreadContext *tc, MVMP6opaqueREPRData *repr_data,
+        MVMuint16 num_classes, MVMuint16 *class_attrs) {
+    MVMuint64 end = packed_layout(tc, repr_data->num_attributes,
+        repr_data->flattened_stables, num_classes, class_attrs,
+        repr_data->attribute_offsets);
+    MVMuint16 i;
+    repr_data->gc_obj_mark_offsets_count = 0;
+    for (i = 0; i < repr_data->num_attributes; i++)
+        if (!repr_data->flattened_stables[i])
+            repr_data->gc_obj_mark_offsets[repr_data->gc_obj_mark_offsets_count++] =
+                repr_data->attribute_offsets[i];
+    return end;
+}
+
+/* Reads the attribute counts of the classes written for a packed layout.
+ * Returns NULL if they do not add up to the number of attributes. */
+static MVMuint16 * read_class_attrs(MVMThreadContext *tc, MVMSerializationReader *reader,
+        MVMuint16 num_attributes, MVMuint16 *num_classes) {
+    MVMuint16 *class_attrs;
+    MVMuint32  total = 0;
+    MVMuint16  i;
+    *num_classes = (MVMuint16)MVM_serialization_read_int(tc, reader);
+    class_attrs  = MVM_malloc(P6OMAX(*num_classes, 1) * sizeof(MVMuint16));
+    for (i = 0; i < *num_classes; i++) {
+        class_attrs[i] = (MVMuint16)MVM_serialization_read_int(tc, reader);
+        total += class_attrs[i];
+    }
+    if (total != num_attributes) {
+        MVM_free(class_attrs);
+        return NULL;
+    }
+    return class_attrs;
+}
+
 static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
     MVMint64   mro_pos, mro_count, num_parents, total_attrs, num_attrs,
                cur_slot, cur_type, cur_obj_attr,
@@ -744,6 +851,10 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
     /* Allocate the representation data. */
     repr_data = (MVMP6opaqueREPRData *)MVM_calloc(1, sizeof(MVMP6opaqueREPRData));
 
+    /* See if the attributes should be packed. */
+    if (MVM_repr_exists_key(tc, info_hash, str_consts.packed))
+        repr_data->packed = 1;
+
     /* In this first pass, we'll loop over the MRO entries, looking for
      * if there is any multiple inheritance and counting the number of
      * attributes. */
@@ -1028,6 +1139,16 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
         cur_type++;
     }
 
+    /* If packing, redo the layout now we know all of the attributes. */
+    if (repr_data->packed) {
+        MVMuint16 *class_attrs = MVM_malloc(P6OMAX(cur_type, 1) * sizeof(MVMuint16));
+        for (i = 0; i < cur_type; i++)
+            class_attrs[i] = repr_data->name_to_index_mapping[i].num_attrs;
+        cur_alloc_addr = apply_packed_layout(tc, repr_data, cur_type, class_attrs);
+        cur_obj_attr   = repr_data->gc_obj_mark_offsets_count;
+        MVM_free(class_attrs);
+    }
+
     align_to(&cur_alloc_addr, ALIGNOF(void *));
 
     /* Add allocated amount for body to have total object size. */
@@ -1053,11 +1174,13 @@ static void deserialize_stable_size(MVMThreadContext *tc, MVMSTable *st, MVMSeri
      * anything flattend in. */
     MVMint64  num_attributes = MVM_serialization_read_int(tc, reader);
     MVMuint64 cur_offset = sizeof(MVMP6opaque);
+    MVMSTable **flattened_stables = MVM_calloc(P6OMAX(num_attributes, 1), sizeof(MVMSTable *));
     MVMint64  i;
     for (i = 0; i < num_attributes; i++) {
         if (MVM_serialization_read_int(tc, reader)) {
             MVMSTable *st = MVM_serialization_read_stable_ref(tc, reader);
             const MVMStorageSpec *ss = st->REPR->get_storage_spec(tc, st);
+            flattened_stables[i] = st;
             if (ss->inlineable) {
                 /* TODO: Review if/when we get sub-byte things. */
                 align_to(&cur_offset, (MVMuint32)ss->align);
@@ -1074,6 +1197,21 @@ static void deserialize_stable_size(MVMThreadContext *tc, MVMSTable *st, MVMSeri
         }
     }
 
+    /* A packed layout is written along with the attribute count of each
+     * class, so we can work out its size. */
+    if (reader->root.version >= 25 && MVM_serialization_read_int(tc, reader)) {
+        MVMuint16  num_classes;
+        MVMuint16 *class_attrs = read_class_attrs(tc, reader, num_attributes, &num_classes);
+        if (!class_attrs) {
+            MVM_free(flattened_stables);
+            MVM_exception_throw_adhoc(tc, "Serialization error: P6opaque's packed layout does not cover its attributes");
+        }
+        cur_offset = packed_layout(tc, num_attributes, flattened_stables,
+            num_classes, class_attrs, NULL) + sizeof(MVMP6opaque) - sizeof(MVMP6opaqueBody);
+        MVM_free(class_attrs);
+    }
+    MVM_free(flattened_stables);
+
     align_to(&cur_offset, ALIGNOF(void *));
     st->size = cur_offset;
     MVM_ASSERT_ALIGNED(st->size, ALIGNOF(void *));
@@ -1090,6 +1228,11 @@ static void serialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializ
             "Representation for %s must be composed before it can be serialized", MVM_6model_get_stable_debug_name(tc, st));
     }
 
+    i = 0;
+    while (repr_data->name_to_index_mapping[i].class_key)
+        i++;
+    num_classes = i;
+
     MVM_serialization_write_int(tc, writer, repr_data->num_attributes);
 
     for (i = 0; i < repr_data->num_attributes; i++) {
@@ -1098,6 +1241,15 @@ static void serialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializ
             MVM_serialization_write_stable_ref(tc, writer, repr_data->flattened_stables[i]);
     }
 
+    if (writer->root.version >= 25) {
+        MVM_serialization_write_int(tc, writer, repr_data->packed);
+        if (repr_data->packed) {
+            MVM_serialization_write_int(tc, writer, num_classes);
+            for (i = 0; i < num_classes; i++)
+                MVM_serialization_write_int(tc, writer, repr_data->name_to_index_mapping[i].num_attrs);
+        }
+    }
+
     MVM_serialization_write_int(tc, writer, repr_data->mi);
 
     if (repr_data->auto_viv_values) {
@@ -1134,10 +1286,6 @@ static void serialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializ
         MVM_serialization_write_int(tc, writer, 0);
     }
 
-    i = 0;
-    while (repr_data->name_to_index_mapping[i].class_key)
-        i++;
-    num_classes = i;
     MVM_serialization_write_int(tc, writer, num_classes);
     for (i = 0; i < num_classes; i++) {
         const MVMuint32 num_attrs = repr_data->name_to_index_mapping[i].num_attrs;
@@ -1160,6 +1308,8 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
     MVMuint32 j;
     MVMuint64 cur_offset;
     MVMint16 cur_initialize_slot, cur_gc_mark_slot, cur_gc_cleanup_slot;
+    MVMuint16 num_packed_classes = 0;
+    MVMuint16 *class_attrs = NULL;
 
     MVMP6opaqueREPRData *repr_data = MVM_calloc(1, sizeof(MVMP6opaqueREPRData));
 
@@ -1174,6 +1324,16 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
             repr_data->flattened_stables[i] = NULL;
         }
 
+    if (reader->root.version >= 25)
+        repr_data->packed = MVM_serialization_read_int(tc, reader);
+    if (repr_data->packed) {
+        class_attrs = read_class_attrs(tc, reader, repr_data->num_attributes, &num_packed_classes);
+        if (!class_attrs) {
+            free_repr_data(repr_data);
+            MVM_exception_throw_adhoc(tc, "Serialization error: P6opaque's packed layout does not cover its attributes");
+        }
+    }
+
     repr_data->mi = MVM_serialization_read_int(tc, reader);
 
     if (MVM_serialization_read_int(tc, reader)) {
@@ -1199,12 +1359,14 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
             MVMuint16 slot = MVM_serialization_read_int(tc, reader);
             if (slot > repr_data->num_attributes) {
                 MVMuint16 num_attributes = repr_data->num_attributes;
+                MVM_free(class_attrs);
                 free_repr_data(repr_data);
                 MVM_exception_throw_adhoc(tc, "Serialization error: P6opaque's unbox slot out of range (slot %d > %d attributes).", slot, num_attributes);
             }
             if (repr_id < MVM_REPR_MAX_COUNT)
                 repr_data->unbox_slots[repr_id] = slot;
             else {
+                MVM_free(class_attrs);
                 free_repr_data(repr_data);
                 MVM_exception_throw_adhoc(tc, "Serialization error: P6opaque's unbox slot repr id out of range (repr id %d >= %d).", repr_id, MVM_REPR_MAX_COUNT);
             }
@@ -1278,6 +1440,7 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
                 repr_data->gc_cleanup_slots[cur_gc_cleanup_slot++] = i;
 
             if (spec->align == 0) {
+                MVM_free(class_attrs);
                 free_repr_data(repr_data);
                 MVM_exception_throw_adhoc(tc, "Serialization error: Storage Spec of P6opaque must not have align set to 0.");
             }
@@ -1290,6 +1453,10 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
             cur_offset += spec->bits / 8;
         }
     }
+    if (repr_data->packed) {
+        cur_offset = apply_packed_layout(tc, repr_data, num_packed_classes, class_attrs);
+        MVM_free(class_attrs);
+    }
     assert(cur_offset <= st->size + sizeof(MVMP6opaqueBody) - sizeof(MVMP6opaque));
     repr_data->initialize_slots[cur_initialize_slot] = -1;
     repr_data->gc_mark_slots[cur_gc_mark_slot] = -1;
@@ -1413,6 +1580,12 @@ static void change_type(MVMThreadContext *tc, MVMObject *obj, MVMObject *new_typ
         new_map_entry++;
     }
 
+    /* The layouts of the classes we share only match if both or neither
+     * of the types pack their attributes. */
+    if (cur_repr_data->packed != new_repr_data->packed)
+        MVM_exception_throw_adhoc(tc,
+            "Incompatible attribute layouts in P6opaque rebless for types %s and %s", MVM_6model_get_debug_name(tc, obj), MVM_6model_get_debug_name(tc, new_type));
+
     /* Resize if needed. */
     if (STABLE(obj)->size != STABLE(new_type)->size) {
         allocate_replaced_body(tc, obj, STABLE(new_type));
@@ -44,6 +44,10 @@ struct MVMP6opaqueREPRData {
     /* Flags if we are MI or not. */
     MVMuint16 mi;
 
+    /* Flags if the attributes of each class are packed, rather than laid out
+     * in declaration order. */
+    MVMuint16 packed;
+
     /* Slot to delegate to when we need to unbox to a native integer. */
     MVMint16 unbox_int_slot;
 
@@ -1,5 +1,6 @@
 #include "moar.h"
 #include "limits.h"
+#include "platform/mmap.h"
 
 /* This representation's function pointer table. */
 static const MVMREPROps VMArray_this_repr;
@@ -108,10 +109,51 @@ static void VMArray_gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVM
     }
 }
 
+/* Drops a reference to a file mapping, unmapping it if it was the last. */
+static void release_mapping(MVMArrayMapping *mapping) {
+    if (MVM_decr(&mapping->refs) == 1) {
+        MVM_platform_unmap_file(mapping->block, mapping->handle, mapping->size);
+        MVM_free(mapping);
+    }
+}
+
+/* Frees the slots of an array, whether its own or a view of a mapping. */
+void MVM_VMArray_free_storage(MVMThreadContext *tc, MVMArrayBody *body) {
+    if (body->mapping) {
+        release_mapping(body->mapping);
+        body->mapping = NULL;
+    }
+    else {
+        MVM_free(body->slots.any);
+    }
+    body->slots.any = NULL;
+}
+
+/* An array viewing a mapped file gets a copy of its elements to own before
+ * it is changed in any way, so the mapping and other views of it are never
+ * written to. */
+static void copy_out_of_mapping(MVMThreadContext *tc, MVMArrayBody *body, MVMArrayREPRData *repr_data) {
+    void *slots = NULL;
+    if (body->elems > 0) {
+        slots = MVM_malloc(body->elems * repr_data->elem_size);
+        memcpy(slots, body->slots.u8 + body->start * repr_data->elem_size,
+            body->elems * repr_data->elem_size);
+    }
+    release_mapping(body->mapping);
+    body->mapping   = NULL;
+    body->slots.any = slots;
+    body->start     = 0;
+    body->ssize     = body->elems;
+}
+MVM_STATIC_INLINE void own_storage(MVMThreadContext *tc, MVMArrayBody *body, MVMArrayREPRData *repr_data) {
+    if (body->mapping)
+        copy_out_of_mapping(tc, body, repr_data);
+}
+
 /* Called by the VM in order to free memory associated with this object. */
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMArray *arr = (MVMArray *)obj;
-    MVM_free(arr->body.slots.any);
+    MVM_VMArray_free_storage(tc, &(arr->body));
 }
 
 /* Marks the representation data in an STable.*/
@@ -406,11 +448,16 @@ static void set_size_internal(MVMThreadContext *tc, MVMArrayBody *body, MVMuint6
     MVMuint64   elems = body->elems;
     MVMuint64   start = body->start;
     MVMuint64   ssize = body->ssize;
-    void       *slots = body->slots.any;
+    void       *slots;
 
     if (n == elems)
         return;
 
+    own_storage(tc, body, repr_data);
+    start = body->start;
+    ssize = body->ssize;
+    slots = body->slots.any;
+
     if (start > 0 && n + start > ssize) {
         /* if there aren't enough slots at the end, shift off empty slots
          * from the beginning first */
@@ -482,6 +529,7 @@ void MVM_VMArray_bind_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
 
     /* Handle negative indexes and resizing if needed. */
     enter_single_user(tc, body);
+    own_storage(tc, body, repr_data);
     if (index < 0) {
         index += body->elems;
         if (index < 0)
@@ -734,6 +782,7 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
      * body size too - however also apply an upper limit on that as in the
      * push-based growth. */
     enter_single_user(tc, body);
+    own_storage(tc, body, repr_data);
     if (body->start < 1) {
         MVMuint64 elems = body->elems;
         MVMuint64 n = MVM_MIN(MVM_MAX(elems, 8), 8192);
@@ -946,8 +995,10 @@ static void copy_elements(MVMThreadContext *tc, MVMObject *src, MVMObject *dest,
                 && (d_repr_data->slot_type != MVM_ARRAY_OBJ || !d_needs_barrier)
                 && d_repr_data->slot_type  != MVM_ARRAY_STR) {
             /* Optimized for copying from a VMArray with same slot type */
-            MVMint64 s_start = s_body->start;
-            MVMint64 d_start = d_body->start;
+            MVMint64 s_start, d_start;
+            own_storage(tc, d_body, d_repr_data);
+            s_start = s_body->start;
+            d_start = d_body->start;
             memcpy( d_body->slots.u8 + (d_start + d_offset) * d_repr_data->elem_size,
                     s_body->slots.u8  + (s_start + s_offset) * s_repr_data->elem_size,
                     d_repr_data->elem_size * elems
@@ -988,7 +1039,7 @@ static void aslice(MVMThreadContext *tc, MVMSTable *st, MVMObject *src, void *da
 static void write_buf(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, char *from, MVMint64 offset, MVMuint64 count) {
     MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
     MVMArrayBody     *body      = (MVMArrayBody *)data;
-    MVMuint64 start = body->start;
+    MVMuint64 start;
     MVMuint64 elems = body->elems;
 
     /* Throw on invalid slot type */
@@ -999,6 +1050,8 @@ static void write_buf(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void
     if (offset < 0) {
         MVM_exception_throw_adhoc(tc, "MVMArray: Index out of bounds");
     }
+    own_storage(tc, body, repr_data);
+    start = body->start;
 
     /* resize the array if necessary*/
     size_t elem_size = repr_data->elem_size;
@@ -1056,6 +1109,7 @@ static void asplice(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
     }
 
     enter_single_user(tc, body);
+    own_storage(tc, body, repr_data);
 
     /* When offset == 0, then we may be able to reduce the memmove
      * calls and reallocs by adjusting SELF's start, elems0, and
@@ -1144,7 +1198,7 @@ static void set_dimensions(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
     set_elems(tc, st, root, data, dimensions[0]);
 }
 
-static MVMStorageSpec get_elem_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
+MVMStorageSpec MVM_VMArray_get_elem_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
     MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
     MVMStorageSpec spec;
 
@@ -1201,6 +1255,7 @@ static AO_t * pos_as_atomic(MVMThreadContext *tc, MVMSTable *st, MVMObject *root
         index += body->elems;
     if (index < 0 || (MVMuint64)index >= body->elems)
         MVM_exception_throw_adhoc(tc, "Index out of bounds in atomic operation on array");
+    own_storage(tc, body, repr_data);
 
     if (sizeof(AO_t) == 8 && (repr_data->slot_type == MVM_ARRAY_I64 ||
             repr_data->slot_type == MVM_ARRAY_U64))
@@ -1221,7 +1276,7 @@ static AO_t * pos_as_atomic_multidim(MVMThreadContext *tc, MVMSTable *st, MVMObj
 }
 
 /* Compose the representation. */
-static void spec_to_repr_data(MVMThreadContext *tc, MVMArrayREPRData *repr_data, const MVMStorageSpec *spec) {
+void MVM_VMArray_spec_to_repr_data(MVMThreadContext *tc, MVMArrayREPRData *repr_data, const MVMStorageSpec *spec) {
     switch (spec->boxed_primitive) {
         case MVM_STORAGE_SPEC_BP_UINT64:
         case MVM_STORAGE_SPEC_BP_INT:
@@ -1327,7 +1382,7 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
         if (!MVM_is_null(tc, type)) {
             const MVMStorageSpec *spec = REPR(type)->get_storage_spec(tc, STABLE(type));
             MVM_ASSIGN_REF(tc, &(st->header), repr_data->elem_type, type);
-            spec_to_repr_data(tc, repr_data, spec);
+            MVM_VMArray_spec_to_repr_data(tc, repr_data, spec);
         }
     }
 }
@@ -1357,7 +1412,7 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
         const MVMStorageSpec *spec;
         MVM_serialization_force_stable(tc, reader, STABLE(type));
         spec = REPR(type)->get_storage_spec(tc, STABLE(type));
-        spec_to_repr_data(tc, repr_data, spec);
+        MVM_VMArray_spec_to_repr_data(tc, repr_data, spec);
     }
 }
 
@@ -1515,7 +1570,7 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
 static MVMuint64 unmanaged_size(MVMThreadContext *tc, MVMSTable *st, void *data) {
     MVMArrayREPRData *repr_data = (MVMArrayREPRData *) st->REPR_data;
     MVMArrayBody     *body      = (MVMArrayBody *)data;
-    return body->ssize * repr_data->elem_size;
+    return body->mapping ? 0 : body->ssize * repr_data->elem_size;
 }
 
 static void describe_refs (MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMSTable *st, void *data) {
@@ -1549,6 +1604,81 @@ static void describe_refs (MVMThreadContext *tc, MVMHeapSnapshotState *ss, MVMST
     }
 }
 
+/* Makes an empty array of an 8-bit integer type view the bytes of a mapped
+ * file, taking over the mapping. The array is allocated before the file is
+ * mapped, so that nothing can throw while the mapping has no owner. */
+void MVM_VMArray_attach_mapping(MVMThreadContext *tc, MVMObject *arr, void *block,
+        void *handle, size_t size) {
+    MVMArrayMapping *mapping;
+    MVMArray        *result = (MVMArray *)arr;
+    MVM_VMArray_free_storage(tc, &(result->body));
+    mapping              = MVM_malloc(sizeof(MVMArrayMapping));
+    mapping->refs        = 1;
+    mapping->block       = block;
+    mapping->handle      = handle;
+    mapping->size        = size;
+    result->body.mapping = mapping;
+    result->body.slots.any = block;
+    result->body.start   = 0;
+    result->body.ssize   = size;
+    result->body.elems   = size;
+}
+
+/* Makes an array of the same type as src viewing count of its elements from
+ * offset onwards. When src is a view of a mapped file, so is the result, and
+ * no elements are copied; otherwise, the elements are copied, as aslice would
+ * do. */
+MVMObject * MVM_VMArray_view(MVMThreadContext *tc, MVMObject *src, MVMint64 offset, MVMint64 count) {
+    MVMArrayBody     *s_body;
+    MVMArrayREPRData *repr_data;
+    MVMArray         *result;
+
+    if (!IS_CONCRETE(src) || REPR(src)->ID != MVM_REPR_ID_VMArray)
+        MVM_exception_throw_adhoc(tc, "Can only take a view of a concrete native array");
+    repr_data = (MVMArrayREPRData *)STABLE(src)->REPR_data;
+    if (repr_data->slot_type == MVM_ARRAY_OBJ || repr_data->slot_type == MVM_ARRAY_STR)
+        MVM_exception_throw_adhoc(tc, "Can only take a view of a native array");
+    s_body = &((MVMArray *)src)->body;
+    if (offset < 0 || count < 0 || (MVMuint64)offset > s_body->elems
+            || (MVMuint64)count > s_body->elems - (MVMuint64)offset)
+        MVM_exception_throw_adhoc(tc,
+            "MVMArray: View of %"PRId64" elements at offset %"PRId64" out of bounds of %"PRIu64" elements",
+            count, offset, s_body->elems);
+
+    MVMROOT(tc, src) {
+        result = (MVMArray *)MVM_repr_alloc_init(tc, STABLE(src)->WHAT);
+    }
+    s_body = &((MVMArray *)src)->body;
+    if (s_body->mapping) {
+        MVM_incr(&s_body->mapping->refs);
+        result->body.mapping   = s_body->mapping;
+        result->body.slots.any = s_body->slots.any;
+        result->body.start     = s_body->start + offset;
+        result->body.ssize     = s_body->start + offset + count;
+        result->body.elems     = count;
+    }
+    else if (count > 0) {
+        result->body.slots.any = MVM_malloc(count * repr_data->elem_size);
+        memcpy(result->body.slots.any,
+            s_body->slots.u8 + (s_body->start + offset) * repr_data->elem_size,
+            count * repr_data->elem_size);
+        result->body.ssize = count;
+        result->body.elems = count;
+    }
+    return (MVMObject *)result;
+}
+
+/* Gets a pointer to the first element of an array, for working on all of
+ * its elements at once. If they are to be written, an array viewing a mapped
+ * file first gets its own copy of them. */
+void * MVM_VMArray_bulk_elems(MVMThreadContext *tc, MVMObject *arr, MVMint64 writable) {
+    MVMArrayREPRData *repr_data = (MVMArrayREPRData *)STABLE(arr)->REPR_data;
+    MVMArrayBody     *body      = &((MVMArray *)arr)->body;
+    if (writable)
+        own_storage(tc, body, repr_data);
+    return body->slots.u8 + body->start * repr_data->elem_size;
+}
+
 /* Initializes the representation. */
 const MVMREPROps * MVMArray_initialize(MVMThreadContext *tc) {
     return &VMArray_this_repr;
@@ -1562,6 +1692,7 @@ static void vmarray_bind_pos_int64(MVMThreadContext *tc, MVMSTable *st, void *da
 
     /* Handle negative indexes and resizing if needed. */
     enter_single_user(tc, body);
+    own_storage(tc, body, (MVMArrayREPRData *)st->REPR_data);
     if (index < 0) {
         index += body->elems;
         if (index < 0)
@@ -1665,7 +1796,7 @@ static const MVMREPROps VMArray_this_repr = {
         bind_pos_multidim,
         dimensions,
         set_dimensions,
-        get_elem_storage_spec,
+        MVM_VMArray_get_elem_storage_spec,
         pos_as_atomic,
         pos_as_atomic_multidim,
         write_buf,
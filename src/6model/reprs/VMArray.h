@@ -32,6 +32,11 @@ struct MVMArrayBody {
         void       *any;
     } slots;
 
+    /* If the slots point into a memory-mapped file rather than storage the
+     * array allocated itself, the mapping, which may be shared with other
+     * arrays viewing parts of the same file. */
+    MVMArrayMapping *mapping;
+
 #if MVM_ARRAY_CONC_DEBUG
     AO_t in_use;
 #endif 
@@ -41,6 +46,15 @@ struct MVMArray {
     MVMArrayBody body;
 };
 
+/* A read-only mapping of a file, shared by the arrays viewing it, and
+ * unmapped once the last of them is freed. */
+struct MVMArrayMapping {
+    AO_t    refs;
+    void   *block;
+    void   *handle;
+    size_t  size;
+};
+
 /* Types of things we may be storing. */
 #define MVM_ARRAY_OBJ   0
 #define MVM_ARRAY_STR   1
@@ -85,3 +99,10 @@ void *MVM_VMArray_find_fast_impl_for_jit(MVMThreadContext *tc, MVMSTable *st, MV
 void MVM_VMArray_bind_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMint64 index, MVMRegister value, MVMuint16 kind);
 
 void MVM_VMArray_push(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMRegister value, MVMuint16 kind);
+void MVM_VMArray_free_storage(MVMThreadContext *tc, MVMArrayBody *body);
+void MVM_VMArray_attach_mapping(MVMThreadContext *tc, MVMObject *arr, void *block,
+    void *handle, size_t size);
+MVMObject * MVM_VMArray_view(MVMThreadContext *tc, MVMObject *src, MVMint64 offset, MVMint64 count);
+void * MVM_VMArray_bulk_elems(MVMThreadContext *tc, MVMObject *arr, MVMint64 writable);
+MVMStorageSpec MVM_VMArray_get_elem_storage_spec(MVMThreadContext *tc, MVMSTable *st);
+void MVM_VMArray_spec_to_repr_data(MVMThreadContext *tc, MVMArrayREPRData *repr_data, const MVMStorageSpec *spec);
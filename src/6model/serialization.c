@@ -10,7 +10,7 @@
 
 /* Version of the serialization format that we are currently at and lowest
  * version we support. */
-#define CURRENT_VERSION 24
+#define CURRENT_VERSION 25
 #define MIN_VERSION     23
 
 /* Various sizes (in bytes). */
@@ -2890,6 +2890,35 @@ MVMObject * MVM_serialization_demand_code(MVMThreadContext *tc, MVMSerialization
     return MVM_repr_at_pos_o(tc, sr->codes_list, idx);
 }
 
+/* Deserializes everything in an SC that has not been yet, rather than waiting
+ * for each piece to be demanded. Deserialization of an SC is guarded by its
+ * own mutex, so this may be called for several SCs at once from different
+ * threads, spreading the work of loading a set of modules over them; threads
+ * only contend when they reach into an SC that another is working on. To
+ * avoid lock order inversions, SCs worked on at the same time should not
+ * depend on one another (for example, do one level of the dependency graph
+ * at a time, starting from the leaves). */
+void MVM_serialization_demand_all(MVMThreadContext *tc, MVMSerializationContext *sc) {
+    MVMSerializationReader *sr = sc->body->sr;
+    MVMuint64 i, num_codes;
+    if (!sr)
+        return;
+    MVMROOT(tc, sc) {
+        MVM_reentrantmutex_lock(tc, (MVMReentrantMutex *)sc->body->mutex);
+        for (i = 0; i < sc->body->num_stables; i++)
+            if (!sc->body->root_stables[i])
+                MVM_serialization_demand_stable(tc, sc, i);
+        for (i = 0; i < sc->body->num_objects; i++)
+            if (!sc->body->root_objects[i])
+                MVM_serialization_demand_object(tc, sc, i);
+        num_codes = MVM_repr_elems(tc, sc->body->root_codes);
+        for (i = sr->num_static_codes; i < num_codes; i++)
+            if (MVM_is_null(tc, MVM_repr_at_pos_o(tc, sc->body->root_codes, i)))
+                MVM_serialization_demand_code(tc, sc, i);
+        MVM_reentrantmutex_unlock(tc, (MVMReentrantMutex *)sc->body->mutex);
+    }
+}
+
 /* Forces us to complete deserialization of a particular STable before work
  * can go on. */
 void MVM_serialization_force_stable(MVMThreadContext *tc, MVMSerializationReader *sr, MVMSTable *st) {
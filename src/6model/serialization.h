@@ -183,6 +183,7 @@ MVMObject * MVM_serialization_serialize(MVMThreadContext *tc, MVMSerializationCo
 MVMObject * MVM_serialization_demand_object(MVMThreadContext *tc, MVMSerializationContext *sc, MVMint64 idx);
 MVMSTable * MVM_serialization_demand_stable(MVMThreadContext *tc, MVMSerializationContext *sc, MVMint64 idx);
 MVMObject * MVM_serialization_demand_code(MVMThreadContext *tc, MVMSerializationContext *sc, MVMint64 idx);
+void MVM_serialization_demand_all(MVMThreadContext *tc, MVMSerializationContext *sc);
 
 /* Reader/writer functions. */
 MVMint64 MVM_serialization_read_int64(MVMThreadContext *tc, MVMSerializationReader *reader);
@@ -886,7 +886,7 @@ MVM_NO_RETURN void MVM_oops(MVMThreadContext *tc, const char *messageFormat, ...
             !tc ? " with NULL tc" :
             (MVMObject *) tc->thread_obj == tc->instance->spesh_thread
             ? " in spesh thread" :
-            (MVMObject *) tc->thread_obj == tc->instance->event_loop_thread
+            tc->event_loop
             ? " in event loop thread" : "");
     va_start(args, messageFormat);
     vfprintf(stderr, messageFormat, args);
@@ -934,7 +934,7 @@ MVM_NO_RETURN void MVM_exception_throw_adhoc_free_va(MVMThreadContext *tc, char
     MVMException *ex;
     const char *special = !tc ? " with NULL tc"
         : (MVMObject *) tc->thread_obj == tc->instance->spesh_thread ? " in spesh thread"
-        : (MVMObject *) tc->thread_obj == tc->instance->event_loop_thread ? " in event loop thread" : NULL;
+        : tc->event_loop ? " in event loop thread" : NULL;
 
     if (special) {
         fprintf(stderr, "MoarVM exception%s treated as oops: ", special);
@@ -63,6 +63,7 @@ struct MVMStringConsts {
     MVMString *positional_delegate;
     MVMString *associative_delegate;
     MVMString *auto_viv_container;
+    MVMString *packed;
     MVMString *done;
     MVMString *error;
     MVMString *stdout_bytes;
@@ -73,7 +74,9 @@ struct MVMStringConsts {
     MVMString *stdin_fd;
     MVMString *stdin_fd_close;
     MVMString *stdout_fd;
+    MVMString *stdout_fd_close;
     MVMString *stderr_fd;
+    MVMString *stderr_fd_close;
     MVMString *nativeref;
     MVMString *refkind;
     MVMString *positional;
@@ -265,6 +268,12 @@ struct MVMInstance {
     MVMuint32                     all_scs_alloc;
     uv_mutex_t                    mutex_sc_registry;
 
+    /* Table of interned strings. The keys are held weakly: they are not
+     * marked, and ones that a full collection did not find alive are
+     * removed before gen2 is swept. The mutex protects the table. */
+    MVMStrHashTable interned_strings;
+    uv_mutex_t      mutex_interned_strings;
+
     /* Mutex to serialize additions of type parameterizations. Global rather
      * than per STable, as this doesn't happen often. */
     uv_mutex_t mutex_parameterization_add;
@@ -372,19 +381,16 @@ struct MVMInstance {
      * I/O and process state
      ************************************************************************/
 
-    /* The event loop thread, a mutex to avoid start-races, a concurrent
-     * queue of tasks that need to be processed by the event loop thread
-     * and an array of active tasks, for the purpose of keeping them GC
-     * marked. */
-    MVMObject        *event_loop_thread;
-    uv_loop_t        *event_loop;
+    /* The pool of event loops (each with its own thread, queues of work to
+     * process and active tasks), how many there are, a counter for handing
+     * out tasks to them round-robin, and a mutex to avoid start-races. */
+    MVMEventLoop     *event_loops;
+    MVMuint32         num_event_loops;
+    AO_t              event_loop_next;
     uv_mutex_t        mutex_event_loop;
-    MVMObject        *event_loop_todo_queue;
-    MVMObject        *event_loop_permit_queue;
-    MVMObject        *event_loop_cancel_queue;
-    MVMObject        *event_loop_active;
-    MVMObject        *event_loop_free_indices;
-    uv_async_t       *event_loop_wakeup;
+
+    /* Milliseconds per tick of the event loops' timer wheels. */
+    MVMuint32         timer_granularity;
 
     /* Standard file handles. */
     MVMObject *stdin_handle;
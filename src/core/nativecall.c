@@ -503,12 +503,10 @@ void * MVM_nativecall_unmarshal_carray(MVMThreadContext *tc, MVMObject *value, M
 void * MVM_nativecall_unmarshal_vmarray(MVMThreadContext *tc, MVMObject *value, MVMint16 unmarshal_kind) {
     if (!IS_CONCRETE(value))
         return NULL;
-    else if (REPR(value)->ID == MVM_REPR_ID_VMArray) {
-        MVMArrayBody *body          = &((MVMArray *)value)->body;
-        MVMArrayREPRData *repr_data = (MVMArrayREPRData *)STABLE(value)->REPR_data;
-        size_t start_pos            = body->start * repr_data->elem_size;
-        return ((char *)body->slots.any) + start_pos;
-    }
+    else if (REPR(value)->ID == MVM_REPR_ID_VMArray)
+        /* Foreign code may write to it, so an array viewing a mapped file
+         * must have a copy of its own first. */
+        return MVM_VMArray_bulk_elems(tc, value, 1);
     else
         unmarshal_error(tc, "VMArray", value, unmarshal_kind);
 }
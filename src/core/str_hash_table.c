@@ -1,6 +1,7 @@
 #include "moar.h"
 
 #define STR_MIN_SIZE_BASE_2 3
+#define STR_SMALL_MIN_ITEMS 4
 
 /* Adapted from the log_base2 function.
  * https://graphics.stanford.edu/~seander/bithacks.html#IntegerLogDeBruijn
@@ -141,6 +142,49 @@ MVM_STATIC_INLINE struct MVMStrHashTableControl *hash_allocate_common(MVMThreadC
     MVMuint8 bucket_right_shift = 8 * sizeof(MVMuint64) - official_size_log2;
     control->key_right_shift = bucket_right_shift - control->metadata_hash_bits;
     control->entry_size = entry_size;
+    control->is_small = 0;
+    control->stale = 0;
+
+    MVMuint8 *metadata = (MVMuint8 *)(control + 1);
+    memset(metadata, 0, metadata_size);
+
+#if MVM_HASH_RANDOMIZE
+    control->salt = MVM_proc_rand_i(tc);
+#else
+    control->salt = 0;
+#endif
+
+    return control;
+}
+
+/* Most hashes only ever hold a handful of keys, for which the full Robin Hood
+ * machinery (and its minimum allocation of 8 + 5 buckets) is overkill. So
+ * until a hash needs more than MVM_STR_HASH_SMALL_MAX_ITEMS entries, we store
+ * them one after another in a "small" hash with room for just max_items, and
+ * find them by linear search. We keep the regular memory layout, claiming an
+ * official size of 1 and a maximum probe distance of max_items, so that the
+ * bucket counts the iterators, copying and freeing code work from come out
+ * right. The metadata of entries in use is 1, and of the rest 0. */
+static struct MVMStrHashTableControl *hash_allocate_small(MVMThreadContext *tc,
+                                                          MVMuint8 entry_size,
+                                                          MVMuint32 max_items) {
+    size_t entries_size = entry_size * max_items;
+    size_t metadata_size = MVM_hash_round_size_up(max_items + 1);
+    size_t total_size
+        = entries_size + sizeof(struct MVMStrHashTableControl) + metadata_size;
+
+    struct MVMStrHashTableControl *control =
+        (struct MVMStrHashTableControl *) ((char *) MVM_malloc(total_size) + entries_size);
+
+    control->official_size_log2 = 0;
+    control->max_items = max_items;
+    control->cur_items = 0;
+    control->metadata_hash_bits = 0;
+    control->max_probe_distance = max_items;
+    control->max_probe_distance_limit = max_items;
+    control->key_right_shift = 0;
+    control->entry_size = entry_size;
+    control->is_small = 1;
     control->stale = 0;
 
     MVMuint8 *metadata = (MVMuint8 *)(control + 1);
@@ -174,6 +218,11 @@ void MVM_str_hash_build(MVMThreadContext *tc,
 #if MVM_HASH_RANDOMIZE
         control->salt = MVM_proc_rand_i(tc);
 #endif
+    } else if (entries <= MVM_STR_HASH_SMALL_MAX_ITEMS) {
+        control = hash_allocate_small(tc, entry_size,
+                                      entries <= STR_SMALL_MIN_ITEMS
+                                      ? STR_SMALL_MIN_ITEMS
+                                      : MVM_STR_HASH_SMALL_MAX_ITEMS);
     } else {
         /* Minimum size we need to allocate, given the load factor. */
         MVMuint32 min_needed = entries * (1.0 / MVM_STR_HASH_LOAD_FACTOR);
@@ -287,7 +336,8 @@ MVM_STATIC_INLINE struct MVMStrHashHandle *hash_insert_internal(MVMThreadContext
         else if (*ls.metadata == ls.probe_distance) {
             struct MVMStrHashHandle *entry = (struct MVMStrHashHandle *) ls.entry_raw;
             if (entry->key == key
-                || (MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
+                || (!MVM_string_both_interned(key, entry->key)
+                    && MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
                     && MVM_string_substrings_equal_nocheck(tc, key, 0,
                                                            MVM_string_graphs_nocheck(tc, key),
                                                            entry->key, 0))) {
@@ -318,6 +368,48 @@ MVM_STATIC_INLINE struct MVMStrHashHandle *hash_insert_internal(MVMThreadContext
     }
 }
 
+/* Adds a new entry to a small hash, which must have room for it and not
+ * already contain the key. */
+MVM_STATIC_INLINE struct MVMStrHashHandle *small_insert_internal(MVMThreadContext *tc,
+                                                                 struct MVMStrHashTableControl *control,
+                                                                 MVMString *key) {
+    struct MVMStrHashHandle *entry = (struct MVMStrHashHandle *)
+        (MVM_str_hash_entries(control) - control->cur_items * control->entry_size);
+    MVM_str_hash_metadata(control)[control->cur_items++] = 1;
+#if HASH_DEBUG_ITER
+    ++control->serial;
+    control->last_delete_at = 0;
+#endif
+    /* Make sure the hash code is cached for later searches to compare. */
+    MVM_string_hash_code(tc, key);
+    entry->key = NULL;
+    return entry;
+}
+
+/* Moves the entries of a full small hash to one twice the size. */
+static struct MVMStrHashTableControl *grow_small_hash(MVMThreadContext *tc,
+                                                      struct MVMStrHashTableControl *control_orig) {
+    MVMuint32 cur_items = control_orig->cur_items;
+    MVMuint8 entry_size = control_orig->entry_size;
+    size_t entries_size = (size_t) entry_size * cur_items;
+    struct MVMStrHashTableControl *control
+        = hash_allocate_small(tc, entry_size, 2 * cur_items);
+
+    control_orig->stale = 1;
+    memcpy(MVM_str_hash_entries(control) + entry_size - entries_size,
+           MVM_str_hash_entries(control_orig) + entry_size - entries_size,
+           entries_size);
+    memset(MVM_str_hash_metadata(control), 1, cur_items);
+    control->cur_items = cur_items;
+#if HASH_DEBUG_ITER
+    control->ht_id = control_orig->ht_id;
+    control->serial = control_orig->serial;
+    control->last_delete_at = control_orig->last_delete_at;
+#endif
+    hash_demolish_internal(tc, control_orig);
+    return control;
+}
+
 static struct MVMStrHashTableControl *maybe_grow_hash(MVMThreadContext *tc,
                                                       struct MVMStrHashTableControl *control) {
     if (MVM_UNLIKELY(control->cur_items == 0 && control->max_items == 0)) {
@@ -328,9 +420,9 @@ static struct MVMStrHashTableControl *maybe_grow_hash(MVMThreadContext *tc,
         struct MVMStrHashTableControl *control_orig = control;
 
         control_orig->stale = 1;
-        control = hash_allocate_common(tc,
-                                       control_orig->entry_size,
-                                       STR_MIN_SIZE_BASE_2);
+        control = hash_allocate_small(tc,
+                                      control_orig->entry_size,
+                                      STR_SMALL_MIN_ITEMS);
 #if HASH_DEBUG_ITER
         control->ht_id = control_orig->ht_id;
         assert(control_orig->serial == 0);
@@ -342,6 +434,21 @@ static struct MVMStrHashTableControl *maybe_grow_hash(MVMThreadContext *tc,
         return control;
     }
 
+    /* A small hash that is full either moves to a bigger small hash or, if it
+     * has reached the limit, becomes a regular hash. (For which the probe
+     * limit handling just below never applies, as it has a max_items of 0.) */
+    MVMuint8 new_size_log2 = control->official_size_log2 + 1;
+    if (control->is_small) {
+        if (control->cur_items < MVM_STR_HASH_SMALL_MAX_ITEMS) {
+            return grow_small_hash(tc, control);
+        }
+        new_size_log2 = MVM_round_up_log_base2((control->cur_items + 1)
+                                               * (1.0 / MVM_STR_HASH_LOAD_FACTOR));
+        if (new_size_log2 < STR_MIN_SIZE_BASE_2) {
+            new_size_log2 = STR_MIN_SIZE_BASE_2;
+        }
+    }
+
     /* control->max_items may have been set to 0 to trigger a call into this
      * function. */
     MVMuint32 max_items = MVM_str_hash_max_items(control);
@@ -398,7 +505,7 @@ static struct MVMStrHashTableControl *maybe_grow_hash(MVMThreadContext *tc,
     control_orig->stale = 1;
     control = hash_allocate_common(tc,
                                    entry_size,
-                                   control_orig->official_size_log2 + 1);
+                                   new_size_log2);
 
 
 #if HASH_DEBUG_ITER
@@ -488,8 +595,16 @@ void *MVM_str_hash_lvalue_fetch_nocheck(MVMThreadContext *tc,
             control = new_control;
         }
     }
+    else if (control->is_small) {
+        struct MVMStrHashHandle *entry = MVM_str_hash_small_find(tc, control, key);
+        if (entry) {
+            return entry;
+        }
+    }
 
-    void *result = hash_insert_internal(tc, control, key);
+    void *result = control->is_small
+        ? small_insert_internal(tc, control, key)
+        : hash_insert_internal(tc, control, key);
     if (MVM_UNLIKELY(control->stale)) {
         MVM_oops(tc, "MVM_str_hash_lvalue_fetch_nocheck called with a hashtable pointer that turned stale");
     }
@@ -529,13 +644,38 @@ void MVM_str_hash_delete_nocheck(MVMThreadContext *tc,
         return;
     }
 
+    if (control->is_small) {
+        struct MVMStrHashHandle *entry = MVM_str_hash_small_find(tc, control, key);
+        if (entry) {
+            /* Move the last entry into the gap. Iteration runs from the last
+             * entry to the first, so when deleting at the current iterator,
+             * the entry we move has already been seen. */
+            MVMuint8 *last = MVM_str_hash_entries(control)
+                - (control->cur_items - 1) * control->entry_size;
+            if ((MVMuint8 *) entry != last) {
+                memcpy(entry, last, control->entry_size);
+            }
+            MVM_str_hash_metadata(control)[--control->cur_items] = 0;
+#if HASH_DEBUG_ITER
+            ++control->serial;
+            control->last_delete_at = 1 + (MVM_str_hash_entries(control) - (MVMuint8 *) entry)
+                / control->entry_size;
+#endif
+        }
+        if (MVM_UNLIKELY(control->stale)) {
+            MVM_oops(tc, "MVM_str_hash_delete_nocheck called with a hashtable pointer that turned stale");
+        }
+        return;
+    }
+
     struct MVM_hash_loop_state ls = MVM_str_hash_create_loop_state(tc, control, key);
 
     while (1) {
         if (*ls.metadata == ls.probe_distance) {
             struct MVMStrHashHandle *entry = (struct MVMStrHashHandle *) ls.entry_raw;
             if (entry->key == key
-                || (MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
+                || (!MVM_string_both_interned(key, entry->key)
+                    && MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
                     && MVM_string_substrings_equal_nocheck(tc, key, 0,
                                                            MVM_string_graphs_nocheck(tc, key),
                                                            entry->key, 0))) {
@@ -711,6 +851,21 @@ static MVMuint64 hash_fsck_internal(MVMThreadContext *tc, struct MVMStrHashTable
         return 0;
     }
 
+    if (control->is_small) {
+        /* The entries in use must be exactly the first cur_items. */
+        MVMuint8 *metadata = MVM_str_hash_metadata(control);
+        MVMuint32 i;
+        for (i = 0; i < control->max_items; i++) {
+            if (metadata[i] != (i < control->cur_items)) {
+                ++errors;
+                if (display) {
+                    fprintf(stderr, "%s%3X! small hash metadata %02x\n", prefix_hashes, i, metadata[i]);
+                }
+            }
+        }
+        return errors;
+    }
+
     MVMuint32 allocated_items = MVM_str_hash_allocated_items(control);
     const MVMuint8 metadata_hash_bits = control->metadata_hash_bits;
     MVMuint8 *entry_raw = MVM_str_hash_entries(control);
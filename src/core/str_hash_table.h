@@ -439,6 +439,14 @@ struct MVMStrHashTableControl {
      * to cache it as we have the space. */
     MVMuint8 max_probe_distance_limit;
     MVMuint8 metadata_hash_bits;
+    /* Set for a small hash, which holds at most MVM_STR_HASH_SMALL_MAX_ITEMS
+     * entries in its first cur_items slots, and searches them linearly rather
+     * than hashing. The memory layout is the same as for a regular hash of
+     * official size 1 and max_items buckets. New entries go in the next free
+     * slot and a delete moves the last entry into the gap, so the iterators,
+     * which run from the last slot to the first, promise no particular
+     * order. */
+    MVMuint8 is_small;
     /* This is set to 0 when the control structure is allocated. When the hash
      * expands (and needs a new larger allocation) this is set to 1 in the
      * soon-to-be-freed memory, and the memory is scheduled to be released at
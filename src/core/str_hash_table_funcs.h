@@ -5,6 +5,8 @@
  * and test with assertions enabled. The current choices permit certain
  * optimisation assumptions in parts of the code. */
 #define MVM_STR_HASH_LOAD_FACTOR 0.75
+/* Hashes with up to this many entries are stored as a small hash. */
+#define MVM_STR_HASH_SMALL_MAX_ITEMS 8
 MVM_STATIC_INLINE MVMuint32 MVM_str_hash_official_size(const struct MVMStrHashTableControl *control) {
     assert(!(control->cur_items == 0 && control->max_items == 0));
     return 1 << (MVMuint32)control->official_size_log2;
@@ -181,6 +183,31 @@ MVM_str_hash_create_loop_state(MVMThreadContext *tc,
     return retval;
 }
 
+/* Finds the entry for a key in a small hash. As the entries are scanned in
+ * turn, their (cached) hash codes are compared first, so that we rarely need
+ * to compare the strings themselves for a key that is not there. */
+MVM_STATIC_INLINE struct MVMStrHashHandle *MVM_str_hash_small_find(MVMThreadContext *tc,
+                                                                  struct MVMStrHashTableControl *control,
+                                                                  MVMString *key) {
+    MVMuint64 hash_val = MVM_string_hash_code(tc, key);
+    MVMuint8 *entry_raw = MVM_str_hash_entries(control);
+    MVMHashNumItems i;
+    for (i = 0; i < control->cur_items; i++) {
+        struct MVMStrHashHandle *entry = (struct MVMStrHashHandle *) entry_raw;
+        if (entry->key == key
+            || (MVM_string_hash_code(tc, entry->key) == hash_val
+                && !MVM_string_both_interned(key, entry->key)
+                && MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
+                && MVM_string_substrings_equal_nocheck(tc, key, 0,
+                                                       MVM_string_graphs_nocheck(tc, key),
+                                                       entry->key, 0))) {
+            return entry;
+        }
+        entry_raw -= control->entry_size;
+    }
+    return NULL;
+}
+
 MVM_STATIC_INLINE void *MVM_str_hash_fetch_nocheck(MVMThreadContext *tc,
                                                    MVMStrHashTable *hashtable,
                                                    MVMString *key) {
@@ -194,6 +221,10 @@ MVM_STATIC_INLINE void *MVM_str_hash_fetch_nocheck(MVMThreadContext *tc,
         return NULL;
     }
 
+    if (control->is_small) {
+        return MVM_str_hash_small_find(tc, control, key);
+    }
+
     struct MVM_hash_loop_state ls = MVM_str_hash_create_loop_state(tc, control, key);
 
     /* Comments in str_hash_table.h describe the various invariants.
@@ -278,7 +309,8 @@ MVM_STATIC_INLINE void *MVM_str_hash_fetch_nocheck(MVMThreadContext *tc,
         if (*ls.metadata == ls.probe_distance) {
             struct MVMStrHashHandle *entry = (struct MVMStrHashHandle *) ls.entry_raw;
             if (entry->key == key
-                || (MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
+                || (!MVM_string_both_interned(key, entry->key)
+                    && MVM_string_graphs_nocheck(tc, key) == MVM_string_graphs_nocheck(tc, entry->key)
                     && MVM_string_substrings_equal_nocheck(tc, key, 0,
                                                            MVM_string_graphs_nocheck(tc, key),
                                                            entry->key, 0))) {
@@ -77,6 +77,9 @@ struct MVMThreadContext {
     /* The VM instance that this thread belongs to. */
     MVMInstance *instance;
 
+    /* The event loop this thread runs, if it's an event loop thread. */
+    MVMEventLoop *event_loop;
+
     /* The number of locks the thread is holding. */
     MVMint64 num_locks;
 
@@ -1651,6 +1651,497 @@ static MVMDispSysCall pty_resize = {
     .expected_concrete = { 1, 1, 1 },
 };
 
+/* unicode-collation-key */
+static void unicode_collation_key_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMString *s = get_str_arg(arg_info, 0);
+    MVMint64 collation_mode = get_int_arg(arg_info, 1);
+    MVMint64 lang_mode = get_int_arg(arg_info, 2);
+    MVMint64 country_mode = get_int_arg(arg_info, 3);
+    MVMString *key = MVM_unicode_string_collation_key(tc, s, collation_mode, lang_mode, country_mode);
+    MVM_args_set_result_str(tc, key, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall unicode_collation_key = {
+    .c_name = "unicode-collation-key",
+    .implementation = unicode_collation_key_impl,
+    .min_args = 4,
+    .max_args = 4,
+    .expected_kinds = { MVM_CALLSITE_ARG_STR, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0, 0, 0 },
+    .expected_concrete = { 1, 1, 1, 1 },
+};
+
+/* intern */
+static void intern_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMString *s = get_str_arg(arg_info, 0);
+    MVM_args_set_result_str(tc, MVM_string_intern(tc, s), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall intern = {
+    .c_name = "intern",
+    .implementation = intern_impl,
+    .min_args = 1,
+    .max_args = 1,
+    .expected_kinds = { MVM_CALLSITE_ARG_STR },
+    .expected_reprs = { 0 },
+    .expected_concrete = { 1 },
+};
+
+/* async-write-vectored */
+static void async_write_vectored_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *handle     = get_obj_arg(arg_info, 0);
+    MVMObject *queue      = get_obj_arg(arg_info, 1);
+    MVMObject *schedulee  = get_obj_arg(arg_info, 2);
+    MVMObject *list       = get_obj_arg(arg_info, 3);
+    MVMObject *async_type = get_obj_arg(arg_info, 4);
+    MVMString *encoding   = get_str_arg(arg_info, 5);
+    MVMint64   notify     = get_int_arg(arg_info, 6);
+    MVMObject *task = MVM_io_write_vectored_async(tc, handle, queue, schedulee, list,
+        async_type, encoding, notify);
+    MVM_args_set_result_obj(tc, task, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall async_write_vectored = {
+    .c_name = "async-write-vectored",
+    .implementation = async_write_vectored_impl,
+    .min_args = 7,
+    .max_args = 7,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ,
+        MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_STR, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { MVM_REPR_ID_MVMOSHandle, MVM_REPR_ID_ConcBlockingQueue, 0,
+        MVM_REPR_ID_VMArray, MVM_REPR_ID_MVMAsyncTask, 0, 0 },
+    .expected_concrete = { 1, 1, 0, 1, 0, 0, 1 },
+};
+
+/* file-map */
+static void file_map_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMString *path     = get_str_arg(arg_info, 0);
+    MVMObject *buf_type = get_obj_arg(arg_info, 1);
+    MVM_args_set_result_obj(tc, MVM_file_map(tc, path, buf_type), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall file_map = {
+    .c_name = "file-map",
+    .implementation = file_map_impl,
+    .min_args = 2,
+    .max_args = 2,
+    .expected_kinds = { MVM_CALLSITE_ARG_STR, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { 0, MVM_REPR_ID_VMArray },
+    .expected_concrete = { 1, 0 },
+};
+
+/* buffer-view */
+static void buffer_view_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *buf    = get_obj_arg(arg_info, 0);
+    MVMint64   offset = get_int_arg(arg_info, 1);
+    MVMint64   count  = get_int_arg(arg_info, 2);
+    MVM_args_set_result_obj(tc, MVM_VMArray_view(tc, buf, offset, count), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall buffer_view = {
+    .c_name = "buffer-view",
+    .implementation = buffer_view_impl,
+    .min_args = 3,
+    .max_args = 3,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { MVM_REPR_ID_VMArray, 0, 0 },
+    .expected_concrete = { 1, 1, 1 },
+};
+
+/* async-file-read */
+static void async_file_read_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *queue      = get_obj_arg(arg_info, 0);
+    MVMObject *schedulee  = get_obj_arg(arg_info, 1);
+    MVMString *path       = get_str_arg(arg_info, 2);
+    MVMObject *buf_type   = get_obj_arg(arg_info, 3);
+    MVMObject *async_type = get_obj_arg(arg_info, 4);
+    MVM_args_set_result_obj(tc, MVM_io_file_read_async(tc, queue, schedulee, path,
+        buf_type, async_type), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall async_file_read = {
+    .c_name = "async-file-read",
+    .implementation = async_file_read_impl,
+    .min_args = 5,
+    .max_args = 5,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_STR,
+        MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_ConcBlockingQueue, 0, 0, MVM_REPR_ID_VMArray,
+        MVM_REPR_ID_MVMAsyncTask },
+    .expected_concrete = { 1, 0, 1, 0, 0 },
+};
+
+/* async-file-write */
+static void async_file_write_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *queue      = get_obj_arg(arg_info, 0);
+    MVMObject *schedulee  = get_obj_arg(arg_info, 1);
+    MVMString *path       = get_str_arg(arg_info, 2);
+    MVMObject *buffer     = get_obj_arg(arg_info, 3);
+    MVMint64   append     = get_int_arg(arg_info, 4);
+    MVMObject *async_type = get_obj_arg(arg_info, 5);
+    MVM_args_set_result_obj(tc, MVM_io_file_write_async(tc, queue, schedulee, path,
+        buffer, append, async_type), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall async_file_write = {
+    .c_name = "async-file-write",
+    .implementation = async_file_write_impl,
+    .min_args = 6,
+    .max_args = 6,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_STR,
+        MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_ConcBlockingQueue, 0, 0, MVM_REPR_ID_VMArray, 0,
+        MVM_REPR_ID_MVMAsyncTask },
+    .expected_concrete = { 1, 0, 1, 1, 1, 0 },
+};
+
+/* async-socket-sendfile */
+static void async_socket_sendfile_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *socket     = get_obj_arg(arg_info, 0);
+    MVMObject *queue      = get_obj_arg(arg_info, 1);
+    MVMObject *schedulee  = get_obj_arg(arg_info, 2);
+    MVMObject *file       = get_obj_arg(arg_info, 3);
+    MVMint64   offset     = get_int_arg(arg_info, 4);
+    MVMint64   length     = get_int_arg(arg_info, 5);
+    MVMObject *async_type = get_obj_arg(arg_info, 6);
+    MVM_args_set_result_obj(tc, MVM_io_socket_sendfile_async(tc, socket, queue, schedulee,
+        file, offset, length, async_type), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall async_socket_sendfile = {
+    .c_name = "async-socket-sendfile",
+    .implementation = async_socket_sendfile_impl,
+    .min_args = 7,
+    .max_args = 7,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ,
+        MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_MVMOSHandle, MVM_REPR_ID_ConcBlockingQueue, 0,
+        MVM_REPR_ID_MVMOSHandle, 0, 0, MVM_REPR_ID_MVMAsyncTask },
+    .expected_concrete = { 1, 1, 0, 1, 1, 1, 0 },
+};
+
+/* sc-deserialize-all */
+static void sc_deserialize_all_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *sc = get_obj_arg(arg_info, 0);
+    MVM_serialization_demand_all(tc, ((MVMSerializationContext *)sc));
+    MVM_args_set_result_obj(tc, sc, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall sc_deserialize_all = {
+    .c_name = "sc-deserialize-all",
+    .implementation = sc_deserialize_all_impl,
+    .min_args = 1,
+    .max_args = 1,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_SCRef },
+    .expected_concrete = { 1 },
+};
+
+/* queue-poll-batch */
+static void queue_poll_batch_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *queue = get_obj_arg(arg_info, 0);
+    MVMint64 max = get_int_arg(arg_info, 1);
+    MVM_args_set_result_obj(tc, MVM_concblockingqueue_poll_batch(tc,
+        (MVMConcBlockingQueue *)queue, max), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall queue_poll_batch = {
+    .c_name = "queue-poll-batch",
+    .implementation = queue_poll_batch_impl,
+    .min_args = 2,
+    .max_args = 2,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { MVM_REPR_ID_ConcBlockingQueue, 0 },
+    .expected_concrete = { 1, 1 },
+};
+
+/* conc-hash-bind-if-absent */
+static void conc_hash_bind_if_absent_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *hash  = get_obj_arg(arg_info, 0);
+    MVMString *key   = get_str_arg(arg_info, 1);
+    MVMObject *value = get_obj_arg(arg_info, 2);
+    MVM_args_set_result_obj(tc, MVM_conc_hash_bind_if_absent(tc, hash, key, value),
+        MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall conc_hash_bind_if_absent = {
+    .c_name = "conc-hash-bind-if-absent",
+    .implementation = conc_hash_bind_if_absent_impl,
+    .min_args = 3,
+    .max_args = 3,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_STR, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_ConcHash, 0, 0 },
+    .expected_concrete = { 1, 1, 0 },
+};
+
+/* conc-hash-cas */
+static void conc_hash_cas_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *hash     = get_obj_arg(arg_info, 0);
+    MVMString *key      = get_str_arg(arg_info, 1);
+    MVMObject *expected = get_obj_arg(arg_info, 2);
+    MVMObject *value    = get_obj_arg(arg_info, 3);
+    MVM_args_set_result_obj(tc, MVM_conc_hash_cas(tc, hash, key, expected, value),
+        MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall conc_hash_cas = {
+    .c_name = "conc-hash-cas",
+    .implementation = conc_hash_cas_impl,
+    .min_args = 4,
+    .max_args = 4,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_STR, MVM_CALLSITE_ARG_OBJ,
+        MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_ConcHash, 0, 0, 0 },
+    .expected_concrete = { 1, 1, 0, 0 },
+};
+
+/* native-array-fill-i */
+static void native_array_fill_i_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *arr = get_obj_arg(arg_info, 0);
+    MVMint64 value = get_int_arg(arg_info, 1);
+    MVM_nativearray_fill_i(tc, arr, value);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_fill_i = {
+    .c_name = "native-array-fill-i",
+    .implementation = native_array_fill_i_impl,
+    .min_args = 2,
+    .max_args = 2,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0 },
+    .expected_concrete = { 1, 0 },
+};
+
+/* native-array-fill-n */
+static void native_array_fill_n_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *arr = get_obj_arg(arg_info, 0);
+    MVMnum64 value = get_num_arg(arg_info, 1);
+    MVM_nativearray_fill_n(tc, arr, value);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_fill_n = {
+    .c_name = "native-array-fill-n",
+    .implementation = native_array_fill_n_impl,
+    .min_args = 2,
+    .max_args = 2,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_NUM },
+    .expected_reprs = { 0, 0 },
+    .expected_concrete = { 1, 0 },
+};
+
+/* native-array-copy */
+static void native_array_copy_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *dest = get_obj_arg(arg_info, 0);
+    MVMint64 dest_offset = get_int_arg(arg_info, 1);
+    MVMObject *src = get_obj_arg(arg_info, 2);
+    MVMint64 src_offset = get_int_arg(arg_info, 3);
+    MVMint64 count = get_int_arg(arg_info, 4);
+    MVM_nativearray_copy(tc, dest, dest_offset, src, src_offset, count);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_copy = {
+    .c_name = "native-array-copy",
+    .implementation = native_array_copy_impl,
+    .min_args = 5,
+    .max_args = 5,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_OBJ,
+        MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0, 0, 0, 0 },
+    .expected_concrete = { 1, 0, 1, 0, 0 },
+};
+
+/* native-array-apply-i */
+static void native_array_apply_i_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *arr = get_obj_arg(arg_info, 0);
+    MVMint64 op = get_int_arg(arg_info, 1);
+    MVMint64 value = get_int_arg(arg_info, 2);
+    MVM_nativearray_apply_i(tc, arr, op, value);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_apply_i = {
+    .c_name = "native-array-apply-i",
+    .implementation = native_array_apply_i_impl,
+    .min_args = 3,
+    .max_args = 3,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0, 0 },
+    .expected_concrete = { 1, 0, 0 },
+};
+
+/* native-array-apply-n */
+static void native_array_apply_n_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *arr = get_obj_arg(arg_info, 0);
+    MVMint64 op = get_int_arg(arg_info, 1);
+    MVMnum64 value = get_num_arg(arg_info, 2);
+    MVM_nativearray_apply_n(tc, arr, op, value);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_apply_n = {
+    .c_name = "native-array-apply-n",
+    .implementation = native_array_apply_n_impl,
+    .min_args = 3,
+    .max_args = 3,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_NUM },
+    .expected_reprs = { 0, 0, 0 },
+    .expected_concrete = { 1, 0, 0 },
+};
+
+/* native-array-apply-array */
+static void native_array_apply_array_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *dest = get_obj_arg(arg_info, 0);
+    MVMint64 op = get_int_arg(arg_info, 1);
+    MVMObject *src = get_obj_arg(arg_info, 2);
+    MVM_nativearray_apply_array(tc, dest, op, src);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_apply_array = {
+    .c_name = "native-array-apply-array",
+    .implementation = native_array_apply_array_impl,
+    .min_args = 3,
+    .max_args = 3,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { 0, 0, 0 },
+    .expected_concrete = { 1, 0, 1 },
+};
+
+/* native-array-fma */
+static void native_array_fma_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *dest = get_obj_arg(arg_info, 0);
+    MVMObject *src = get_obj_arg(arg_info, 1);
+    MVMnum64 scale = get_num_arg(arg_info, 2);
+    MVM_nativearray_fma(tc, dest, src, scale);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_fma = {
+    .c_name = "native-array-fma",
+    .implementation = native_array_fma_impl,
+    .min_args = 3,
+    .max_args = 3,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_NUM },
+    .expected_reprs = { 0, 0, 0 },
+    .expected_concrete = { 1, 1, 0 },
+};
+
+/* native-array-reduce-i */
+static void native_array_reduce_i_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *arr = get_obj_arg(arg_info, 0);
+    MVMint64 op = get_int_arg(arg_info, 1);
+    MVM_args_set_result_int(tc, MVM_nativearray_reduce_i(tc, arr, op), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_reduce_i = {
+    .c_name = "native-array-reduce-i",
+    .implementation = native_array_reduce_i_impl,
+    .min_args = 2,
+    .max_args = 2,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0 },
+    .expected_concrete = { 1, 0 },
+};
+
+/* native-array-reduce-n */
+static void native_array_reduce_n_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *arr = get_obj_arg(arg_info, 0);
+    MVMint64 op = get_int_arg(arg_info, 1);
+    MVM_args_set_result_num(tc, MVM_nativearray_reduce_n(tc, arr, op), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_reduce_n = {
+    .c_name = "native-array-reduce-n",
+    .implementation = native_array_reduce_n_impl,
+    .min_args = 2,
+    .max_args = 2,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0 },
+    .expected_concrete = { 1, 0 },
+};
+
+/* native-array-compare-i */
+static void native_array_compare_i_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *mask = get_obj_arg(arg_info, 0);
+    MVMObject *arr = get_obj_arg(arg_info, 1);
+    MVMint64 op = get_int_arg(arg_info, 2);
+    MVMint64 value = get_int_arg(arg_info, 3);
+    MVM_nativearray_compare_i(tc, mask, arr, op, value);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_compare_i = {
+    .c_name = "native-array-compare-i",
+    .implementation = native_array_compare_i_impl,
+    .min_args = 4,
+    .max_args = 4,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT,
+        MVM_CALLSITE_ARG_INT },
+    .expected_reprs = { 0, 0, 0, 0 },
+    .expected_concrete = { 1, 1, 0, 0 },
+};
+
+/* native-array-compare-n */
+static void native_array_compare_n_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *mask = get_obj_arg(arg_info, 0);
+    MVMObject *arr = get_obj_arg(arg_info, 1);
+    MVMint64 op = get_int_arg(arg_info, 2);
+    MVMnum64 value = get_num_arg(arg_info, 3);
+    MVM_nativearray_compare_n(tc, mask, arr, op, value);
+    MVM_args_set_result_obj(tc, tc->instance->VMNull, MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall native_array_compare_n = {
+    .c_name = "native-array-compare-n",
+    .implementation = native_array_compare_n_impl,
+    .min_args = 4,
+    .max_args = 4,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_INT,
+        MVM_CALLSITE_ARG_NUM },
+    .expected_reprs = { 0, 0, 0, 0 },
+    .expected_concrete = { 1, 1, 0, 0 },
+};
+
+/* async-udp-read-batch */
+static void async_udp_read_batch_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *socket     = get_obj_arg(arg_info, 0);
+    MVMObject *queue      = get_obj_arg(arg_info, 1);
+    MVMObject *schedulee  = get_obj_arg(arg_info, 2);
+    MVMObject *buf_type   = get_obj_arg(arg_info, 3);
+    MVMObject *async_type = get_obj_arg(arg_info, 4);
+    MVM_args_set_result_obj(tc, MVM_io_socket_udp_read_batch_async(tc, socket, queue,
+        schedulee, buf_type, async_type), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall async_udp_read_batch = {
+    .c_name = "async-udp-read-batch",
+    .implementation = async_udp_read_batch_impl,
+    .min_args = 5,
+    .max_args = 5,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ,
+        MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_MVMOSHandle, MVM_REPR_ID_ConcBlockingQueue, 0,
+        MVM_REPR_ID_VMArray, MVM_REPR_ID_MVMAsyncTask },
+    .expected_concrete = { 1, 1, 0, 0, 0 },
+};
+
+/* async-udp-write-batch */
+static void async_udp_write_batch_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVMObject *socket     = get_obj_arg(arg_info, 0);
+    MVMObject *queue      = get_obj_arg(arg_info, 1);
+    MVMObject *schedulee  = get_obj_arg(arg_info, 2);
+    MVMObject *datagrams  = get_obj_arg(arg_info, 3);
+    MVMString *host       = get_str_arg(arg_info, 4);
+    MVMint64   port       = get_int_arg(arg_info, 5);
+    MVMObject *async_type = get_obj_arg(arg_info, 6);
+    MVM_args_set_result_obj(tc, MVM_io_socket_udp_write_batch_async(tc, socket, queue,
+        schedulee, datagrams, host, port, async_type), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall async_udp_write_batch = {
+    .c_name = "async-udp-write-batch",
+    .implementation = async_udp_write_batch_impl,
+    .min_args = 7,
+    .max_args = 7,
+    .expected_kinds = { MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_OBJ,
+        MVM_CALLSITE_ARG_OBJ, MVM_CALLSITE_ARG_STR, MVM_CALLSITE_ARG_INT, MVM_CALLSITE_ARG_OBJ },
+    .expected_reprs = { MVM_REPR_ID_MVMOSHandle, MVM_REPR_ID_ConcBlockingQueue, 0,
+        MVM_REPR_ID_VMArray, 0, 0, MVM_REPR_ID_MVMAsyncTask },
+    .expected_concrete = { 1, 1, 0, 1, 1, 1, 0 },
+};
+
+/* proc-pipe */
+static void proc_pipe_impl(MVMThreadContext *tc, MVMArgs arg_info) {
+    MVM_args_set_result_obj(tc, MVM_proc_pipe(tc), MVM_RETURN_CURRENT_FRAME);
+}
+static MVMDispSysCall proc_pipe = {
+    .c_name = "proc-pipe",
+    .implementation = proc_pipe_impl,
+    .min_args = 0,
+    .max_args = 0,
+    .expected_kinds = { 0 },
+    .expected_reprs = { 0 },
+    .expected_concrete = { 0 },
+};
+
 /* Add all of the syscalls into the hash. */
 MVM_STATIC_INLINE void add_to_hash(MVMThreadContext *tc, MVMDispSysCall *syscall) {
     MVMString *name = MVM_string_ascii_decode_nt(tc, tc->instance->VMString, syscall->c_name);
@@ -1753,6 +2244,32 @@ void MVM_disp_syscall_setup(MVMThreadContext *tc) {
     add_to_hash(tc, &telemetry_interval_annotate);
     add_to_hash(tc, &is_debugserver_running);
     add_to_hash(tc, &pty_resize);
+    add_to_hash(tc, &unicode_collation_key);
+    add_to_hash(tc, &intern);
+    add_to_hash(tc, &async_write_vectored);
+    add_to_hash(tc, &file_map);
+    add_to_hash(tc, &buffer_view);
+    add_to_hash(tc, &async_file_read);
+    add_to_hash(tc, &async_file_write);
+    add_to_hash(tc, &async_socket_sendfile);
+    add_to_hash(tc, &proc_pipe);
+    add_to_hash(tc, &async_udp_read_batch);
+    add_to_hash(tc, &async_udp_write_batch);
+    add_to_hash(tc, &sc_deserialize_all);
+    add_to_hash(tc, &queue_poll_batch);
+    add_to_hash(tc, &conc_hash_bind_if_absent);
+    add_to_hash(tc, &conc_hash_cas);
+    add_to_hash(tc, &native_array_fill_i);
+    add_to_hash(tc, &native_array_fill_n);
+    add_to_hash(tc, &native_array_copy);
+    add_to_hash(tc, &native_array_apply_i);
+    add_to_hash(tc, &native_array_apply_n);
+    add_to_hash(tc, &native_array_apply_array);
+    add_to_hash(tc, &native_array_fma);
+    add_to_hash(tc, &native_array_reduce_i);
+    add_to_hash(tc, &native_array_reduce_n);
+    add_to_hash(tc, &native_array_compare_i);
+    add_to_hash(tc, &native_array_compare_n);
     MVM_gc_allocate_gen2_default_clear(tc);
 }
 
@@ -179,6 +179,7 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
                     MVM_gc_root_gen2_cleanup(cur_thread->body.tc);
                 cur_thread = cur_thread->body.next;
             }
+            MVM_string_intern_cleanup(tc);
         }
 
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
@@ -575,9 +576,8 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
         uv_cond_broadcast(&tc->instance->cond_gc_start);
         uv_mutex_unlock(&tc->instance->mutex_gc_orchestrate);
 
-        /* If there's an event loop thread, wake it up to participate. */
-        if (tc->instance->event_loop_wakeup)
-            uv_async_send(tc->instance->event_loop_wakeup);
+        /* If there are event loop threads, wake them up to participate. */
+        MVM_io_eventloop_wakeup_all(tc);
 
         /* Wait for other threads to be ready. */
         uv_mutex_lock(&tc->instance->mutex_gc_orchestrate);
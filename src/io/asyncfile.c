@@ -0,0 +1,325 @@
+#include "moar.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#define DEFAULT_MODE 0x01B6
+#else
+#include <fcntl.h>
+#define O_CREAT  _O_CREAT
+#define O_RDONLY _O_RDONLY
+#define O_WRONLY _O_WRONLY
+#define O_TRUNC  _O_TRUNC
+#define O_APPEND _O_APPEND
+#define DEFAULT_MODE _S_IWRITE
+#endif
+
+/* Whole-file reads and writes done on the event loop with libuv's file
+ * operations, which a libuv built with io_uring support (on Linux) submits
+ * to the kernel from the loop itself rather than handing them to its thread
+ * pool. Each task opens the file, reads or writes all of it, closes it, and
+ * then pushes a single notification. Since the loop sets up all of the tasks
+ * queued since it last woke before polling, many small files queued at once
+ * have their operations submitted together. */
+
+/* Size of each chunk read from files that report no size (such as those on
+ * /proc), and so are read until EOF. */
+#define CHUNK_SIZE 65536
+
+#define MVM_MIN(a,b) ((a)<(b)?(a):(b))
+
+/* Info we convey about a file read or write task. */
+typedef struct {
+    char             *path;
+    MVMObject        *buf_type;
+    MVMObject        *buf_data;
+    uv_loop_t        *loop;
+    uv_fs_t           req;
+    uv_file           fd;
+    int               writing;
+    int               append;
+    char             *data;
+    MVMuint64         size;
+    MVMuint64         done;
+    int               sized;
+    int               error;
+    MVMThreadContext *tc;
+    int               work_idx;
+} FileInfo;
+
+/* Pushes the outcome of a task to its queue: the schedulee, then for a read
+ * the buffer and for a write the number of bytes written, and then the error
+ * message, if any. */
+static void notify(MVMThreadContext *tc, FileInfo *fi) {
+    MVMAsyncTask *t   = MVM_io_eventloop_get_active_work(tc, fi->work_idx);
+    MVMObject    *arr;
+    MVMROOT(tc, t) {
+        arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+        MVM_repr_push_o(tc, arr, t->body.schedulee);
+        if (fi->error >= 0) {
+            MVMROOT(tc, arr) {
+                MVMObject *result;
+                if (fi->writing) {
+                    result = MVM_repr_box_int(tc, tc->instance->boot_types.BOOTInt, fi->done);
+                }
+                else {
+                    MVMArray *res_buf = (MVMArray *)MVM_repr_alloc_init(tc, fi->buf_type);
+                    res_buf->body.slots.i8 = (MVMint8 *)fi->data;
+                    res_buf->body.start    = 0;
+                    res_buf->body.ssize    = fi->size;
+                    res_buf->body.elems    = fi->done;
+                    fi->data               = NULL;
+                    result                 = (MVMObject *)res_buf;
+                }
+                MVM_repr_push_o(tc, arr, result);
+            }
+            MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
+        }
+        else {
+            MVM_repr_push_o(tc, arr, fi->writing
+                ? tc->instance->boot_types.BOOTInt
+                : fi->buf_type);
+            MVMROOT(tc, arr) {
+                MVMString *msg_str = MVM_string_ascii_decode_nt(tc,
+                    tc->instance->VMString, uv_strerror(fi->error));
+                MVMObject *msg_box = MVM_repr_box_str(tc,
+                    tc->instance->boot_types.BOOTStr, msg_str);
+                MVM_repr_push_o(tc, arr, msg_box);
+            }
+        }
+        MVM_repr_push_o(tc, t->body.queue, arr);
+    }
+    MVM_free_null(fi->data);
+    MVM_io_eventloop_remove_active_work(tc, &(fi->work_idx));
+}
+
+static void on_close(uv_fs_t *req) {
+    FileInfo *fi = (FileInfo *)req->data;
+    uv_fs_req_cleanup(req);
+    notify(fi->tc, fi);
+}
+
+/* Closes the file, or if it was never opened just reports the outcome. */
+static void finish(FileInfo *fi, int error) {
+    if (error < 0)
+        fi->error = error;
+    if (fi->fd >= 0) {
+        int r = uv_fs_close(fi->loop, &(fi->req), fi->fd, on_close);
+        fi->fd = -1;
+        if (r >= 0)
+            return;
+    }
+    notify(fi->tc, fi);
+}
+
+static void read_more(FileInfo *fi);
+static void on_read(uv_fs_t *req) {
+    FileInfo *fi = (FileInfo *)req->data;
+    ssize_t   r  = req->result;
+    uv_fs_req_cleanup(req);
+    if (r < 0) {
+        finish(fi, (int)r);
+    }
+    else {
+        fi->done += r;
+        /* We're done at EOF, or once we've read as much as the file had when
+         * we looked at its size. */
+        if (r == 0 || (fi->sized && fi->done == fi->size))
+            finish(fi, 0);
+        else
+            read_more(fi);
+    }
+}
+static void read_more(FileInfo *fi) {
+    uv_buf_t buf;
+    int      r;
+    if (fi->done == fi->size) {
+        fi->size = fi->size ? fi->size * 2 : CHUNK_SIZE;
+        fi->data = MVM_realloc(fi->data, fi->size);
+    }
+    buf = uv_buf_init(fi->data + fi->done, (unsigned int)MVM_MIN(fi->size - fi->done, INT_MAX));
+    if ((r = uv_fs_read(fi->loop, &(fi->req), fi->fd, &buf, 1, -1, on_read)) < 0)
+        finish(fi, r);
+}
+
+static void write_more(FileInfo *fi);
+static void on_write(uv_fs_t *req) {
+    FileInfo *fi = (FileInfo *)req->data;
+    ssize_t   r  = req->result;
+    uv_fs_req_cleanup(req);
+    if (r < 0) {
+        finish(fi, (int)r);
+    }
+    else {
+        fi->done += r;
+        if (fi->done == fi->size)
+            finish(fi, 0);
+        else
+            write_more(fi);
+    }
+}
+static void write_more(FileInfo *fi) {
+    uv_buf_t buf = uv_buf_init(fi->data + fi->done,
+        (unsigned int)MVM_MIN(fi->size - fi->done, INT_MAX));
+    int r;
+    if ((r = uv_fs_write(fi->loop, &(fi->req), fi->fd, &buf, 1, -1, on_write)) < 0)
+        finish(fi, r);
+}
+
+static void on_stat(uv_fs_t *req) {
+    FileInfo *fi = (FileInfo *)req->data;
+    ssize_t   r  = req->result;
+    MVMuint64 size = req->statbuf.st_size;
+    uv_fs_req_cleanup(req);
+    if (r < 0) {
+        finish(fi, (int)r);
+    }
+    else {
+        /* Read exactly the size of the file, if it has one, so that a file
+         * takes a single read. */
+        if (size > 0) {
+            fi->size  = size;
+            fi->sized = 1;
+            fi->data  = MVM_malloc(size);
+        }
+        read_more(fi);
+    }
+}
+
+static void on_open(uv_fs_t *req) {
+    FileInfo *fi = (FileInfo *)req->data;
+    ssize_t   r  = req->result;
+    uv_fs_req_cleanup(req);
+    if (r < 0) {
+        finish(fi, (int)r);
+    }
+    else {
+        fi->fd = (uv_file)r;
+        if (fi->writing) {
+            if (fi->size == 0)
+                finish(fi, 0);
+            else
+                write_more(fi);
+        }
+        else if ((r = uv_fs_fstat(fi->loop, req, fi->fd, on_stat)) < 0) {
+            finish(fi, (int)r);
+        }
+    }
+}
+
+/* Sets the task up on the event loop by starting to open the file. */
+static void setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    FileInfo *fi = (FileInfo *)data;
+    int flags, r;
+    fi->tc       = tc;
+    fi->work_idx = MVM_io_eventloop_add_active_work(tc, async_task);
+    fi->fd       = -1;
+    fi->loop     = loop;
+    fi->req.data = fi;
+
+    /* Writes take a copy of the data to write, so they are not affected by
+     * changes to the buffer while in progress. */
+    if (fi->writing) {
+        MVMArray *buffer = (MVMArray *)fi->buf_data;
+        fi->size = buffer->body.elems;
+        if (fi->size) {
+            fi->data = MVM_malloc(fi->size);
+            memcpy(fi->data, buffer->body.slots.i8 + buffer->body.start, fi->size);
+        }
+        flags = O_CREAT | O_WRONLY | (fi->append ? O_APPEND : O_TRUNC);
+    }
+    else {
+        flags = O_RDONLY;
+    }
+
+    if ((r = uv_fs_open(loop, &(fi->req), fi->path, flags, DEFAULT_MODE, on_open)) < 0)
+        finish(fi, r);
+}
+
+/* Marks objects for a file task. */
+static void gc_mark(MVMThreadContext *tc, void *data, MVMGCWorklist *worklist) {
+    FileInfo *fi = (FileInfo *)data;
+    MVM_gc_worklist_add(tc, worklist, &fi->buf_type);
+    MVM_gc_worklist_add(tc, worklist, &fi->buf_data);
+}
+
+/* Frees info for a file task. */
+static void gc_free(MVMThreadContext *tc, MVMObject *t, void *data) {
+    if (data) {
+        FileInfo *fi = (FileInfo *)data;
+        MVM_free(fi->path);
+        MVM_free(fi->data);
+        MVM_free(data);
+    }
+}
+
+/* Operations table for async file tasks. */
+static const MVMAsyncTaskOps op_table = {
+    setup,
+    NULL,
+    NULL,
+    gc_mark,
+    gc_free
+};
+
+static MVMObject * make_task(MVMThreadContext *tc, MVMObject *queue, MVMObject *schedulee,
+        MVMString *path, MVMObject *buf_type, MVMObject *buffer, MVMint64 append,
+        MVMObject *async_type, const char *what) {
+    MVMAsyncTask     *task;
+    FileInfo         *fi;
+    MVMArrayREPRData *repr_data;
+
+    /* Validate REPRs. */
+    if (REPR(queue)->ID != MVM_REPR_ID_ConcBlockingQueue)
+        MVM_exception_throw_adhoc(tc,
+            "%s target queue must have ConcBlockingQueue REPR", what);
+    if (REPR(async_type)->ID != MVM_REPR_ID_MVMAsyncTask)
+        MVM_exception_throw_adhoc(tc,
+            "%s result type must have REPR AsyncTask", what);
+    if (REPR(buf_type)->ID != MVM_REPR_ID_VMArray)
+        MVM_exception_throw_adhoc(tc, "%s requires a native array", what);
+    repr_data = (MVMArrayREPRData *)STABLE(buf_type)->REPR_data;
+    if (!repr_data || (repr_data->slot_type != MVM_ARRAY_U8 && repr_data->slot_type != MVM_ARRAY_I8))
+        MVM_exception_throw_adhoc(tc, "%s requires a native array of uint8 or int8", what);
+
+    /* Create async task handle. */
+    MVMROOT5(tc, queue, schedulee, buf_type, buffer, path) {
+        task = (MVMAsyncTask *)MVM_repr_alloc_init(tc, async_type);
+    }
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
+    task->body.ops  = &op_table;
+    fi              = MVM_calloc(1, sizeof(FileInfo));
+    MVM_ASSIGN_REF(tc, &(task->common.header), fi->buf_type, buf_type);
+    if (buffer)
+        MVM_ASSIGN_REF(tc, &(task->common.header), fi->buf_data, buffer);
+    fi->writing     = buffer != NULL;
+    fi->append      = append != 0;
+    task->body.data = fi;
+    MVMROOT(tc, task) {
+        fi->path = MVM_platform_path(tc, path);
+    }
+
+    /* Hand the task off to the event loop. */
+    MVMROOT(tc, task) {
+        MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
+    }
+
+    return (MVMObject *)task;
+}
+
+/* Reads a whole file asynchronously into a buffer of the given type. */
+MVMObject * MVM_io_file_read_async(MVMThreadContext *tc, MVMObject *queue, MVMObject *schedulee,
+        MVMString *path, MVMObject *buf_type, MVMObject *async_type) {
+    return make_task(tc, queue, schedulee, path, buf_type, NULL, 0, async_type,
+        "asyncfileread");
+}
+
+/* Writes a buffer asynchronously to a file, replacing or appending to what
+ * the file held. */
+MVMObject * MVM_io_file_write_async(MVMThreadContext *tc, MVMObject *queue, MVMObject *schedulee,
+        MVMString *path, MVMObject *buffer, MVMint64 append, MVMObject *async_type) {
+    if (!IS_CONCRETE(buffer))
+        MVM_exception_throw_adhoc(tc, "asyncfilewrite requires a native array to write from");
+    return make_task(tc, queue, schedulee, path, STABLE(buffer)->WHAT, buffer, append,
+        async_type, "asyncfilewrite");
+}
@@ -0,0 +1,4 @@
+MVMObject * MVM_io_file_read_async(MVMThreadContext *tc, MVMObject *queue, MVMObject *schedulee,
+    MVMString *path, MVMObject *buf_type, MVMObject *async_type);
+MVMObject * MVM_io_file_write_async(MVMThreadContext *tc, MVMObject *queue, MVMObject *schedulee,
+    MVMString *path, MVMObject *buffer, MVMint64 append, MVMObject *async_type);
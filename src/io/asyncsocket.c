@@ -1,11 +1,96 @@
 #include "moar.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+/* A write or sendfile that was held back behind a sendfile on the socket.
+ * Its task is already in the active work list; start sets it going. */
+typedef struct {
+    void (*start) (MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data);
+    int   work_idx;
+    int   wait_for_writes;
+} MVMIOAsyncSocketDeferred;
+
 /* Data that we keep for an asynchronous socket handle. */
 typedef struct {
     /* The libuv handle to the socket. */
     uv_stream_t *handle;
+
+    /* Writes handed to libuv that have not completed yet. */
+    MVMuint32 writes_pending;
+
+    /* Whether a sendfile is writing to the socket. Its bytes don't go
+     * through the stream's write queue, so anything written after it has
+     * to wait until it is done, and it has to wait for earlier writes. */
+    MVMuint32 sending_file;
+
+    /* Writes and sendfiles held back to keep that ordering, oldest first. */
+    MVMIOAsyncSocketDeferred *deferred;
+    MVMuint32                 num_deferred;
+    MVMuint32                 alloc_deferred;
 } MVMIOAsyncSocketData;
 
+/* Gets the event loop the socket's libuv handle lives on; tasks using the
+ * socket must be pinned to it. */
+static MVMEventLoop * socket_loop(MVMOSHandle *h) {
+    return MVM_io_eventloop_of_handle((uv_handle_t *)((MVMIOAsyncSocketData *)h->body.data)->handle);
+}
+
+/* Whether every write handed to libuv for the socket has gone out. */
+static int writes_done(MVMIOAsyncSocketData *handle_data) {
+    return handle_data->writes_pending == 0 && (!handle_data->handle
+        || uv_stream_get_write_queue_size(handle_data->handle) == 0);
+}
+
+/* Whether a write must be held back behind a sendfile. */
+static int must_defer(MVMIOAsyncSocketData *handle_data) {
+    return handle_data->sending_file || handle_data->num_deferred;
+}
+
+/* Holds back a write or sendfile whose task is in the active work list at
+ * work_idx, to be started in order once the way is clear. */
+static void defer_start(MVMIOAsyncSocketData *handle_data, int work_idx, int wait_for_writes,
+        void (*start) (MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data)) {
+    MVMIOAsyncSocketDeferred *d;
+    if (handle_data->num_deferred == handle_data->alloc_deferred) {
+        handle_data->alloc_deferred = handle_data->alloc_deferred
+            ? handle_data->alloc_deferred * 2
+            : 4;
+        handle_data->deferred = MVM_realloc(handle_data->deferred,
+            handle_data->alloc_deferred * sizeof(MVMIOAsyncSocketDeferred));
+    }
+    d = &(handle_data->deferred[handle_data->num_deferred++]);
+    d->start           = start;
+    d->work_idx        = work_idx;
+    d->wait_for_writes = wait_for_writes;
+}
+
+/* Starts held back writes and sendfiles, oldest first, until one has to
+ * wait for a sendfile or for the writes ahead of it. */
+static void run_deferred(MVMThreadContext *tc, MVMIOAsyncSocketData *handle_data) {
+    while (handle_data->num_deferred && !handle_data->sending_file) {
+        MVMIOAsyncSocketDeferred  d = handle_data->deferred[0];
+        MVMAsyncTask             *t;
+        if (d.wait_for_writes && !writes_done(handle_data))
+            break;
+        if (--handle_data->num_deferred)
+            memmove(handle_data->deferred, handle_data->deferred + 1,
+                handle_data->num_deferred * sizeof(MVMIOAsyncSocketDeferred));
+        t = MVM_io_eventloop_get_active_work(tc, d.work_idx);
+        d.start(tc, tc->event_loop->loop, (MVMObject *)t, t->body.data);
+    }
+    if (!handle_data->num_deferred && handle_data->deferred) {
+        MVM_free_null(handle_data->deferred);
+        handle_data->alloc_deferred = 0;
+    }
+}
+
 /* Info we convey about a read task. */
 typedef struct {
     MVMOSHandle      *handle;
@@ -15,11 +100,9 @@ typedef struct {
     int               work_idx;
 } ReadInfo;
 
-/* Allocates a buffer of the suggested size. */
+/* Lends out the event loop's read buffer. */
 static void on_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
-    size_t size = suggested_size > 0 ? suggested_size : 4;
-    buf->base   = MVM_malloc(size);
-    buf->len    = size;
+    MVM_io_eventloop_alloc_read_buffer(handle, suggested_size, buf);
 }
 
 /* Callback used to simply free memory on close. */
@@ -45,9 +128,10 @@ static void on_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf) {
 
             /* Produce a buffer and push it. */
             res_buf      = (MVMArray *)MVM_repr_alloc_init(tc, ri->buf_type);
-            res_buf->body.slots.i8 = (MVMint8 *)buf->base;
+            res_buf->body.slots.i8 = (MVMint8 *)MVM_io_eventloop_take_read_buffer(
+                (uv_handle_t *)handle, buf, nread);
             res_buf->body.start    = 0;
-            res_buf->body.ssize    = buf->len;
+            res_buf->body.ssize    = nread;
             res_buf->body.elems    = nread;
             MVM_repr_push_o(tc, arr, (MVMObject *)res_buf);
 
@@ -78,8 +162,7 @@ static void on_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf) {
                 MVM_repr_push_o(tc, arr, msg_box);
             }
         }
-        if (buf->base)
-            MVM_free(buf->base);
+        MVM_io_eventloop_take_read_buffer((uv_handle_t *)handle, buf, 0);
         MVM_io_eventloop_remove_active_work(tc, &(ri->work_idx));
         if (conn_handle && !uv_is_closing(conn_handle)) {
             handle_data->handle = NULL;
@@ -205,6 +288,7 @@ static MVMAsyncTask * read_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObject
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
     task->body.ops  = &read_op_table;
+    task->body.loop  = socket_loop(h);
     ri              = MVM_calloc(1, sizeof(ReadInfo));
     MVM_ASSIGN_REF(tc, &(task->common.header), ri->buf_type, buf_type);
     MVM_ASSIGN_REF(tc, &(task->common.header), ri->handle, h);
@@ -218,28 +302,47 @@ static MVMAsyncTask * read_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObject
     return task;
 }
 
-/* Info we convey about a write task. */
+/* Info we convey about a write task. A plain write has a single buffer in
+ * buf_data; a vectored write has a list of them, where any strings in the
+ * list were encoded up front into the matching slot of encoded. */
 typedef struct {
     MVMOSHandle      *handle;
     MVMObject        *buf_data;
     uv_write_t       *req;
     uv_buf_t          buf;
+    uv_buf_t         *bufs;
+    unsigned int      num_bufs;
+    MVMuint64        *encoded_sizes;
+    char            **encoded;
+    MVMuint64         total;
+    int               notify;
     MVMThreadContext *tc;
     int               work_idx;
 } WriteInfo;
 
 /* Completion handler for an asynchronous write. */
 static void on_write(uv_write_t *req, int status) {
-    WriteInfo        *wi  = (WriteInfo *)req->data;
-    MVMThreadContext *tc  = wi->tc;
-    MVMObject        *arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
-    MVMAsyncTask     *t   = MVM_io_eventloop_get_active_work(tc, wi->work_idx);
+    WriteInfo            *wi          = (WriteInfo *)req->data;
+    MVMThreadContext     *tc          = wi->tc;
+    MVMIOAsyncSocketData *handle_data = (MVMIOAsyncSocketData *)wi->handle->body.data;
+    MVMObject            *arr;
+    MVMAsyncTask         *t;
+    handle_data->writes_pending--;
+    if (status >= 0 && !wi->notify) {
+        /* Caller only wants to hear about failures. */
+        MVM_free(wi->req);
+        MVM_io_eventloop_remove_active_work(tc, &(wi->work_idx));
+        run_deferred(tc, handle_data);
+        return;
+    }
+    arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+    t   = MVM_io_eventloop_get_active_work(tc, wi->work_idx);
     MVM_repr_push_o(tc, arr, t->body.schedulee);
     if (status >= 0) {
         MVMROOT2(tc, arr, t) {
             MVMObject *bytes_box = MVM_repr_box_int(tc,
                 tc->instance->boot_types.BOOTInt,
-                wi->buf.len);
+                wi->total);
             MVM_repr_push_o(tc, arr, bytes_box);
         }
         MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
@@ -257,10 +360,11 @@ static void on_write(uv_write_t *req, int status) {
     MVM_repr_push_o(tc, t->body.queue, arr);
     MVM_free(wi->req);
     MVM_io_eventloop_remove_active_work(tc, &(wi->work_idx));
+    run_deferred(tc, handle_data);
 }
 
-/* Does setup work for an asynchronous write. */
-static void write_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+/* Hands a write to libuv; its task is already in the active work list. */
+static void write_start(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
     MVMIOAsyncSocketData *handle_data;
     MVMArray             *buffer;
     WriteInfo            *wi;
@@ -284,24 +388,43 @@ static void write_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
             }
             MVM_repr_push_o(tc, ((MVMAsyncTask *)async_task)->body.queue, arr);
         }
+        MVM_io_eventloop_remove_active_work(tc, &(wi->work_idx));
         return;
     }
 
-    /* Add to work in progress. */
-    wi->tc = tc;
-    wi->work_idx = MVM_io_eventloop_add_active_work(tc, async_task);
-
-    /* Extract buf data. */
-    buffer = (MVMArray *)wi->buf_data;
-    output = (char *)(buffer->body.slots.i8 + buffer->body.start);
-    output_size = (int)buffer->body.elems;
+    /* Extract buf data; for a vectored write, that's one uv_buf_t per list
+     * element, so they all go out in a single write. */
+    if (wi->encoded) {
+        MVMObject    *list = wi->buf_data;
+        unsigned int  i;
+        wi->total = 0;
+        for (i = 0; i < wi->num_bufs; i++) {
+            if (wi->encoded[i]) {
+                wi->bufs[i] = uv_buf_init(wi->encoded[i], (unsigned int)wi->encoded_sizes[i]);
+            }
+            else {
+                buffer = (MVMArray *)MVM_repr_at_pos_o(tc, list, i);
+                output = (char *)(buffer->body.slots.i8 + buffer->body.start);
+                wi->bufs[i] = uv_buf_init(output, (unsigned int)buffer->body.elems);
+            }
+            wi->total += wi->bufs[i].len;
+        }
+    }
+    else {
+        buffer = (MVMArray *)wi->buf_data;
+        output = (char *)(buffer->body.slots.i8 + buffer->body.start);
+        output_size = (int)buffer->body.elems;
+        wi->buf       = uv_buf_init(output, output_size);
+        wi->bufs      = &(wi->buf);
+        wi->num_bufs  = 1;
+        wi->total     = output_size;
+    }
 
     /* Create and initialize write request. */
     wi->req           = MVM_malloc(sizeof(uv_write_t));
-    wi->buf           = uv_buf_init(output, output_size);
     wi->req->data     = data;
 
-    if ((r = uv_write(wi->req, handle_data->handle, &(wi->buf), 1, on_write)) < 0) {
+    if ((r = uv_write(wi->req, handle_data->handle, wi->bufs, wi->num_bufs, on_write)) < 0) {
         /* Error; need to notify. */
         MVMROOT(tc, async_task) {
             MVMObject    *arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
@@ -321,6 +444,24 @@ static void write_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
         MVM_free_null(wi->req);
         MVM_io_eventloop_remove_active_work(tc, &(wi->work_idx));
     }
+    else {
+        handle_data->writes_pending++;
+    }
+}
+
+/* Does setup work for an asynchronous write, holding it back if it would
+ * otherwise overtake a sendfile. */
+static void write_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    WriteInfo            *wi          = (WriteInfo *)data;
+    MVMIOAsyncSocketData *handle_data = (MVMIOAsyncSocketData *)wi->handle->body.data;
+
+    /* Add to work in progress. */
+    wi->tc       = tc;
+    wi->work_idx = MVM_io_eventloop_add_active_work(tc, async_task);
+    if (must_defer(handle_data))
+        defer_start(handle_data, wi->work_idx, 0, write_start);
+    else
+        write_start(tc, loop, async_task, data);
 }
 
 /* Marks objects for a write task. */
@@ -332,8 +473,18 @@ static void write_gc_mark(MVMThreadContext *tc, void *data, MVMGCWorklist *workl
 
 /* Frees info for a write task. */
 static void write_gc_free(MVMThreadContext *tc, MVMObject *t, void *data) {
-    if (data)
+    if (data) {
+        WriteInfo *wi = (WriteInfo *)data;
+        if (wi->encoded) {
+            unsigned int i;
+            for (i = 0; i < wi->num_bufs; i++)
+                MVM_free(wi->encoded[i]);
+            MVM_free(wi->encoded);
+            MVM_free(wi->encoded_sizes);
+            MVM_free(wi->bufs);
+        }
         MVM_free(data);
+    }
 }
 
 /* Operations table for async write task. */
@@ -370,9 +521,11 @@ static MVMAsyncTask * write_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObjec
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
     task->body.ops  = &write_op_table;
+    task->body.loop  = socket_loop(h);
     wi              = MVM_calloc(1, sizeof(WriteInfo));
     MVM_ASSIGN_REF(tc, &(task->common.header), wi->handle, h);
     MVM_ASSIGN_REF(tc, &(task->common.header), wi->buf_data, buffer);
+    wi->notify      = 1;
     task->body.data = wi;
 
     /* Hand the task off to the event loop. */
@@ -383,6 +536,346 @@ static MVMAsyncTask * write_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObjec
     return task;
 }
 
+/* Writes a list of buffers, and strings to be encoded with the given encoding,
+ * as a single write. Unless notify is set, only a failure is reported to the
+ * queue. */
+static MVMAsyncTask * write_vectored(MVMThreadContext *tc, MVMOSHandle *h, MVMObject *queue,
+                                     MVMObject *schedulee, MVMObject *list, MVMObject *async_type,
+                                     MVMString *encoding, MVMint64 notify) {
+    MVMAsyncTask  *task;
+    WriteInfo     *wi;
+    MVMuint64      i, num_bufs;
+    MVMint64       encoding_flag;
+
+    /* Validate REPRs. */
+    if (REPR(queue)->ID != MVM_REPR_ID_ConcBlockingQueue)
+        MVM_exception_throw_adhoc(tc,
+            "asyncwritevectored target queue must have ConcBlockingQueue REPR");
+    if (REPR(async_type)->ID != MVM_REPR_ID_MVMAsyncTask)
+        MVM_exception_throw_adhoc(tc,
+            "asyncwritevectored result type must have REPR AsyncTask");
+    if (!IS_CONCRETE(list) || REPR(list)->ID != MVM_REPR_ID_VMArray
+        || ((MVMArrayREPRData *)STABLE(list)->REPR_data)->slot_type != MVM_ARRAY_OBJ)
+        MVM_exception_throw_adhoc(tc, "asyncwritevectored requires a list of buffers to write");
+    num_bufs = MVM_repr_elems(tc, list);
+    if (num_bufs == 0 || num_bufs > UINT_MAX)
+        MVM_exception_throw_adhoc(tc,
+            "asyncwritevectored requires between 1 and %u buffers", UINT_MAX);
+
+    /* Check what we've been given before allocating anything. */
+    for (i = 0; i < num_bufs; i++) {
+        MVMObject *item = MVM_repr_at_pos_o(tc, list, i);
+        if (!IS_CONCRETE(item))
+            MVM_exception_throw_adhoc(tc, "asyncwritevectored cannot write a type object");
+        if (REPR(item)->ID == MVM_REPR_ID_VMArray) {
+            MVMuint16 slot_type = ((MVMArrayREPRData *)STABLE(item)->REPR_data)->slot_type;
+            if (slot_type != MVM_ARRAY_U8 && slot_type != MVM_ARRAY_I8)
+                MVM_exception_throw_adhoc(tc,
+                    "asyncwritevectored requires native arrays of uint8 or int8");
+        }
+        else if (REPR(item)->ID == MVM_REPR_ID_MVMString
+                || REPR(item)->get_storage_spec(tc, STABLE(item))->can_box & MVM_STORAGE_SPEC_CAN_BOX_STR) {
+            if (!encoding)
+                MVM_exception_throw_adhoc(tc,
+                    "asyncwritevectored requires an encoding to write strings");
+        }
+        else {
+            MVM_exception_throw_adhoc(tc,
+                "asyncwritevectored can only write native arrays of uint8 or int8, and strings");
+        }
+    }
+
+    /* Look up the encoding before allocating anything, in case it is bad. */
+    encoding_flag = encoding ? MVM_string_find_encoding(tc, encoding) : 0;
+
+    /* Take a private copy of the list, so later changes to it can't affect
+     * the write, and encode any strings up front, so the event loop only
+     * ever has bytes to deal with. The task owns the encoded strings from the
+     * start, so they are freed along with it if encoding one of them throws. */
+    MVMROOT6(tc, queue, schedulee, h, list, async_type, encoding) {
+        MVMObject *bufs = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+        MVMROOT(tc, bufs) {
+            task = (MVMAsyncTask *)MVM_repr_alloc_init(tc, async_type);
+        }
+        MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
+        MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
+        task->body.ops     = &write_op_table;
+        task->body.loop    = socket_loop(h);
+        wi                 = MVM_calloc(1, sizeof(WriteInfo));
+        MVM_ASSIGN_REF(tc, &(task->common.header), wi->handle, h);
+        MVM_ASSIGN_REF(tc, &(task->common.header), wi->buf_data, bufs);
+        wi->num_bufs       = (unsigned int)num_bufs;
+        wi->bufs           = MVM_malloc(num_bufs * sizeof(uv_buf_t));
+        wi->encoded        = MVM_calloc(num_bufs, sizeof(char *));
+        wi->encoded_sizes  = MVM_calloc(num_bufs, sizeof(MVMuint64));
+        wi->notify         = notify ? 1 : 0;
+        task->body.data    = wi;
+        MVMROOT(tc, task) {
+            for (i = 0; i < num_bufs; i++) {
+                MVMObject *item = MVM_repr_at_pos_o(tc, list, i);
+                MVM_repr_push_o(tc, wi->buf_data, item);
+                if (REPR(item)->ID != MVM_REPR_ID_VMArray) {
+                    MVMString *s = REPR(item)->ID == MVM_REPR_ID_MVMString
+                        ? (MVMString *)item
+                        : MVM_repr_get_str(tc, item);
+                    wi->encoded[i] = MVM_string_encode(tc, s, 0, -1,
+                        &(wi->encoded_sizes[i]), encoding_flag, NULL, 0);
+                }
+            }
+        }
+    }
+
+    /* Hand the task off to the event loop. */
+    MVMROOT(tc, task) {
+        MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
+    }
+
+    return task;
+}
+
+#ifndef _WIN32
+/* How long a sendfile may go without the socket taking any more bytes
+ * before it fails, in milliseconds. */
+#define SENDFILE_STALL_TIMEOUT 60000
+
+/* The most bytes a sendfile sends each time the socket becomes writable, so
+ * that a fast peer doesn't keep the event loop from everything else. */
+#define SENDFILE_BURST (4 * 1024 * 1024)
+
+/* Info we convey about a sendfile task. */
+typedef struct {
+    MVMOSHandle      *handle;
+    uv_poll_t         poll;
+    uv_timer_t        timer;
+    int               handles_open;
+    int               in_fd;
+    int               out_fd;
+    MVMint64          offset;
+    MVMint64          length;
+    MVMint64          sent;
+    int               error;
+#ifndef __linux__
+    char             *buf;
+    size_t            buf_len;
+    size_t            buf_pos;
+#endif
+    MVMThreadContext *tc;
+    int               work_idx;
+} SendFileInfo;
+
+/* Sends as much of the byte range of the file to the socket as it will take
+ * without blocking, up to SENDFILE_BURST bytes. On Linux, sendfile has the
+ * kernel move the data; elsewhere, it is read and written a chunk at a time,
+ * keeping anything the socket didn't take for next time. Returns 0, or a
+ * libuv error code. */
+static int sendfile_some(SendFileInfo *si) {
+    MVMint64 budget = SENDFILE_BURST;
+    while (si->sent < si->length && budget > 0) {
+        size_t  chunk = si->length - si->sent > budget ? budget : si->length - si->sent;
+        ssize_t r;
+#ifdef __linux__
+        off_t   off   = si->offset + si->sent;
+        r = sendfile(si->out_fd, si->in_fd, &off, chunk);
+        if (r == 0) {
+            si->length = si->sent; /* File ended before the range did. */
+            break;
+        }
+#else
+        if (si->buf_pos == si->buf_len) {
+            r = pread(si->in_fd, si->buf, chunk > 65536 ? 65536 : chunk,
+                si->offset + si->sent);
+            if (r == 0) {
+                si->length = si->sent; /* File ended before the range did. */
+                break;
+            }
+            if (r < 0) {
+                if (errno == EINTR)
+                    continue;
+                return uv_translate_sys_error(errno);
+            }
+            si->buf_len = r;
+            si->buf_pos = 0;
+        }
+        r = write(si->out_fd, si->buf + si->buf_pos, si->buf_len - si->buf_pos);
+        if (r == 0)
+            return 0;
+        if (r > 0)
+            si->buf_pos += r;
+#endif
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+            return uv_translate_sys_error(errno);
+        }
+        si->sent += r;
+        budget   -= r;
+    }
+    return 0;
+}
+
+/* Reports completion of a sendfile, once its poll and timer handles are
+ * closed, and releases its descriptors. */
+static void sendfile_done(SendFileInfo *si) {
+    MVMThreadContext     *tc          = si->tc;
+    MVMIOAsyncSocketData *handle_data = (MVMIOAsyncSocketData *)si->handle->body.data;
+    MVMObject            *arr         = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+    MVMAsyncTask         *t           = MVM_io_eventloop_get_active_work(tc, si->work_idx);
+    close(si->in_fd);
+    si->in_fd = -1;
+    if (si->out_fd >= 0) {
+        close(si->out_fd);
+        si->out_fd = -1;
+    }
+#ifndef __linux__
+    MVM_free_null(si->buf);
+#endif
+    MVM_repr_push_o(tc, arr, t->body.schedulee);
+    if (si->error == 0) {
+        MVMROOT2(tc, arr, t) {
+            MVMObject *bytes_box = MVM_repr_box_int(tc,
+                tc->instance->boot_types.BOOTInt, si->sent);
+            MVM_repr_push_o(tc, arr, bytes_box);
+        }
+        MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
+    }
+    else {
+        MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTInt);
+        MVMROOT2(tc, arr, t) {
+            MVMString *msg_str = MVM_string_ascii_decode_nt(tc,
+                tc->instance->VMString, uv_strerror(si->error));
+            MVMObject *msg_box = MVM_repr_box_str(tc,
+                tc->instance->boot_types.BOOTStr, msg_str);
+            MVM_repr_push_o(tc, arr, msg_box);
+        }
+    }
+    MVM_repr_push_o(tc, t->body.queue, arr);
+    MVM_io_eventloop_remove_active_work(tc, &(si->work_idx));
+    handle_data->sending_file = 0;
+    run_deferred(tc, handle_data);
+}
+static void sendfile_handle_closed(uv_handle_t *handle) {
+    SendFileInfo *si = (SendFileInfo *)handle->data;
+    if (--si->handles_open == 0)
+        sendfile_done(si);
+}
+
+/* Ends a sendfile, closing its poll and timer handles. */
+static void sendfile_finish(SendFileInfo *si, int error) {
+    si->error = error;
+    uv_poll_stop(&(si->poll));
+    uv_timer_stop(&(si->timer));
+    uv_close((uv_handle_t *)&(si->poll), sendfile_handle_closed);
+    uv_close((uv_handle_t *)&(si->timer), sendfile_handle_closed);
+}
+
+/* Sends more of the file each time the socket can be written to. */
+static void sendfile_on_writable(uv_poll_t *handle, int status, int events) {
+    SendFileInfo *si   = (SendFileInfo *)handle->data;
+    MVMint64      sent = si->sent;
+    int           r    = status < 0 ? status : sendfile_some(si);
+    if (r < 0 || si->sent >= si->length)
+        sendfile_finish(si, r);
+    else if (si->sent != sent)
+        uv_timer_again(&(si->timer));
+}
+
+/* Fails a sendfile that the socket has stopped taking bytes for. */
+static void sendfile_on_timeout(uv_timer_t *handle) {
+    sendfile_finish((SendFileInfo *)handle->data, UV_ETIMEDOUT);
+}
+
+/* Starts a sendfile; its task is already in the active work list. It is
+ * driven from the event loop, sending whenever the socket becomes writable,
+ * through a descriptor of its own for the socket, so that closing the
+ * socket's handle can't make the rest of the bytes go to whatever next gets
+ * its descriptor; the connection stays open until the sendfile ends. */
+static void sendfile_start(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    SendFileInfo         *si          = (SendFileInfo *)data;
+    MVMIOAsyncSocketData *handle_data = (MVMIOAsyncSocketData *)si->handle->body.data;
+    uv_os_fd_t            fd;
+    int                   r;
+
+    handle_data->sending_file = 1;
+    if (!handle_data->handle || uv_is_closing((uv_handle_t *)handle_data->handle))
+        r = UV_EBADF;
+    else if ((r = uv_fileno((uv_handle_t *)handle_data->handle, &fd)) == 0) {
+        if ((si->out_fd = dup(fd)) < 0 || fcntl(si->out_fd, F_SETFL,
+                fcntl(si->out_fd, F_GETFL) | O_NONBLOCK) == -1)
+            r = uv_translate_sys_error(errno);
+    }
+    if (r == 0 && si->length < 0) {
+        struct stat statbuf;
+        if (fstat(si->in_fd, &statbuf) == -1)
+            r = uv_translate_sys_error(errno);
+        else
+            si->length = statbuf.st_size > si->offset ? statbuf.st_size - si->offset : 0;
+    }
+    if (r == 0)
+        r = uv_poll_init(loop, &(si->poll), si->out_fd);
+    if (r < 0) {
+        si->error = r;
+        sendfile_done(si);
+        return;
+    }
+#ifndef __linux__
+    si->buf = MVM_malloc(65536);
+#endif
+    uv_timer_init(loop, &(si->timer));
+    si->poll.data     = si;
+    si->timer.data    = si;
+    si->handles_open  = 2;
+    if ((r = uv_poll_start(&(si->poll), UV_WRITABLE, sendfile_on_writable)) < 0)
+        sendfile_finish(si, r);
+    else
+        uv_timer_start(&(si->timer), sendfile_on_timeout, SENDFILE_STALL_TIMEOUT,
+            SENDFILE_STALL_TIMEOUT);
+}
+
+/* Does setup work for a sendfile. Since its bytes bypass the stream's write
+ * queue, it waits until earlier writes have gone out, and until any
+ * sendfile or write ahead of it is done. */
+static void sendfile_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    SendFileInfo         *si          = (SendFileInfo *)data;
+    MVMIOAsyncSocketData *handle_data = (MVMIOAsyncSocketData *)si->handle->body.data;
+
+    /* Add to work in progress. */
+    si->tc       = tc;
+    si->work_idx = MVM_io_eventloop_add_active_work(tc, async_task);
+    if (must_defer(handle_data) || !writes_done(handle_data))
+        defer_start(handle_data, si->work_idx, 1, sendfile_start);
+    else
+        sendfile_start(tc, loop, async_task, data);
+}
+
+/* Marks objects for a sendfile task. */
+static void sendfile_gc_mark(MVMThreadContext *tc, void *data, MVMGCWorklist *worklist) {
+    SendFileInfo *si = (SendFileInfo *)data;
+    MVM_gc_worklist_add(tc, worklist, &si->handle);
+}
+
+/* Frees info for a sendfile task, closing our descriptor for the file if
+ * the task never got to run. */
+static void sendfile_gc_free(MVMThreadContext *tc, MVMObject *t, void *data) {
+    if (data) {
+        SendFileInfo *si = (SendFileInfo *)data;
+        if (si->in_fd >= 0)
+            close(si->in_fd);
+        MVM_free(data);
+    }
+}
+
+/* Operations table for async sendfile task. */
+static const MVMAsyncTaskOps sendfile_op_table = {
+    sendfile_setup,
+    NULL,
+    NULL,
+    sendfile_gc_mark,
+    sendfile_gc_free
+};
+#endif
+
 /* Info we convey about a socket close task. */
 typedef struct {
     MVMOSHandle *handle;
@@ -429,6 +922,7 @@ static MVMint64 close_socket(MVMThreadContext *tc, MVMOSHandle *h) {
             tc->instance->boot_types.BOOTAsync);
     }
     task->body.ops = &close_op_table;
+    task->body.loop = socket_loop(h);
     ci = MVM_calloc(1, sizeof(CloseInfo));
     MVM_ASSIGN_REF(tc, &(task->common.header), ci->handle, h);
     task->body.data = ci;
@@ -457,7 +951,7 @@ static MVMint64 socket_handle(MVMThreadContext *tc, MVMOSHandle *h) {
 /* IO ops table, populated with functions. */
 static const MVMIOClosable      closable       = { close_socket };
 static const MVMIOAsyncReadable async_readable = { read_bytes };
-static const MVMIOAsyncWritable async_writable = { write_bytes };
+static const MVMIOAsyncWritable async_writable = { write_bytes, write_vectored };
 static const MVMIOIntrospection introspection  = { socket_is_tty, socket_handle, NULL };
 static const MVMIOOps op_table = {
     &closable,
@@ -845,12 +1339,102 @@ typedef struct {
 } ListenInfo;
 
 
-/* Handles an incoming connection. */
+#ifndef _WIN32
+/* Info we convey about handing an accepted connection over to another event
+ * loop in the pool. libuv handles can't move between loops, so the listening
+ * loop accepts the connection and gives up a duplicate of its descriptor,
+ * which the target loop then opens a handle of its own on. */
+typedef struct {
+    /* The duplicated descriptor, or -1 once the target loop took it. */
+    int fd;
+
+    /* The result for the listener, which still lacks the connection's
+     * handle. */
+    MVMObject *arr;
+
+    /* The listen task, to send the result to. */
+    MVMObject *listen_task;
+} HandOffInfo;
+
+/* Opens the handed off connection on the loop it was handed to, and sends
+ * the listener's result. */
+static void hand_off_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    HandOffInfo *hi     = (HandOffInfo *)data;
+    uv_tcp_t    *client = MVM_malloc(sizeof(uv_tcp_t));
+    int          r;
+
+    uv_tcp_init(loop, client);
+    if ((r = uv_tcp_open(client, hi->fd)) == 0) {
+        MVMOSHandle          *result = (MVMOSHandle *)MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTIO);
+        MVMIOAsyncSocketData *data   = MVM_calloc(1, sizeof(MVMIOAsyncSocketData));
+        data->handle                 = (uv_stream_t *)client;
+        result->body.ops             = &op_table;
+        result->body.data            = data;
+        MVM_repr_bind_pos_o(tc, hi->arr, 1, (MVMObject *)result);
+    }
+    else {
+        MVMString *msg_str;
+        MVMObject *msg_box;
+        close(hi->fd);
+        uv_close((uv_handle_t *)client, free_on_close_cb);
+        msg_str = MVM_string_ascii_decode_nt(tc, tc->instance->VMString, uv_strerror(r));
+        msg_box = MVM_repr_box_str(tc, tc->instance->boot_types.BOOTStr, msg_str);
+        MVM_repr_bind_pos_o(tc, hi->arr, 2, msg_box);
+    }
+    hi->fd = -1;
+    MVM_repr_push_o(tc, ((MVMAsyncTask *)hi->listen_task)->body.queue, hi->arr);
+}
+
+/* Marks objects for a hand-off task. */
+static void hand_off_gc_mark(MVMThreadContext *tc, void *data, MVMGCWorklist *worklist) {
+    HandOffInfo *hi = (HandOffInfo *)data;
+    MVM_gc_worklist_add(tc, worklist, &hi->arr);
+    MVM_gc_worklist_add(tc, worklist, &hi->listen_task);
+}
+
+/* Frees info for a hand-off task, closing the connection if it never got
+ * handed off. */
+static void hand_off_gc_free(MVMThreadContext *tc, MVMObject *t, void *data) {
+    if (data) {
+        HandOffInfo *hi = (HandOffInfo *)data;
+        if (hi->fd >= 0)
+            close(hi->fd);
+        MVM_free(hi);
+    }
+}
+
+/* Operations table for a connection hand-off task. */
+static const MVMAsyncTaskOps hand_off_op_table = {
+    hand_off_setup,
+    NULL,
+    NULL,
+    hand_off_gc_mark,
+    hand_off_gc_free
+};
+
+/* Picks an event loop for an accepted connection and, if it's not the one we
+ * are on, gets a duplicate of the connection's descriptor to hand over to it.
+ * Returns -1 to keep the connection on this loop. */
+static int hand_off_fd(MVMThreadContext *tc, uv_tcp_t *client, MVMEventLoop **target) {
+    uv_os_fd_t fd;
+    *target = MVM_io_eventloop_pick(tc);
+    if (*target == tc->event_loop || uv_fileno((uv_handle_t *)client, &fd) != 0)
+        return -1;
+    return dup(fd);
+}
+#endif
+
+/* Handles an incoming connection. When there is a pool of event loops, the
+ * connections are spread over them round-robin. */
 static void on_connection(uv_stream_t *server, int status) {
     ListenInfo       *li     = (ListenInfo *)server->data;
     MVMThreadContext *tc     = li->tc;
     MVMObject        *arr    = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
     MVMAsyncTask     *t      = MVM_io_eventloop_get_active_work(tc, li->work_idx);
+    int               hand_off = -1;
+#ifndef _WIN32
+    MVMEventLoop     *target = NULL;
+#endif
 
     uv_tcp_t         *client = MVM_malloc(sizeof(uv_tcp_t));
     int               r;
@@ -858,12 +1442,20 @@ static void on_connection(uv_stream_t *server, int status) {
 
     MVM_repr_push_o(tc, arr, t->body.schedulee);
     if ((r = uv_accept(server, (uv_stream_t *)client)) == 0) {
+#ifndef _WIN32
+        hand_off = hand_off_fd(tc, client, &target);
+#endif
+
         /* Allocate and set up handle. */
         MVMROOT2(tc, arr, t) {
             struct sockaddr_storage sockaddr;
             int name_len = sizeof(struct sockaddr_storage);
 
-            {
+            if (hand_off >= 0) {
+                /* The loop we hand the connection to fills in the handle. */
+                MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTIO);
+            }
+            else {
                 MVMOSHandle          *result = (MVMOSHandle *)MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTIO);
                 MVMIOAsyncSocketData *data   = MVM_calloc(1, sizeof(MVMIOAsyncSocketData));
                 data->handle                 = (uv_stream_t *)client;
@@ -871,6 +1463,9 @@ static void on_connection(uv_stream_t *server, int status) {
                 result->body.data            = data;
 
                 MVM_repr_push_o(tc, arr, (MVMObject *)result);
+            }
+
+            {
                 MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
 
                 uv_tcp_getpeername(client, (struct sockaddr *)&sockaddr, &name_len);
@@ -890,6 +1485,27 @@ static void on_connection(uv_stream_t *server, int status) {
                 push_name_and_port(tc, &sockaddr, arr);
             }
         }
+
+#ifndef _WIN32
+        if (hand_off >= 0) {
+            MVMAsyncTask *task;
+            HandOffInfo  *hi;
+            uv_close((uv_handle_t *)client, free_on_close_cb);
+            MVMROOT2(tc, arr, t) {
+                task = (MVMAsyncTask *)MVM_repr_alloc_init(tc,
+                    tc->instance->boot_types.BOOTAsync);
+            }
+            task->body.ops  = &hand_off_op_table;
+            task->body.loop = target;
+            hi              = MVM_calloc(1, sizeof(HandOffInfo));
+            hi->fd          = hand_off;
+            MVM_ASSIGN_REF(tc, &(task->common.header), hi->arr, arr);
+            MVM_ASSIGN_REF(tc, &(task->common.header), hi->listen_task, t);
+            task->body.data = hi;
+            MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
+            return;
+        }
+#endif
     }
     else {
         uv_close((uv_handle_t*)client, NULL);
@@ -1267,3 +1883,67 @@ MVMObject * MVM_io_socket_listen_unix_async(MVMThreadContext *tc, MVMObject *que
 
     return (MVMObject *)task;
 }
+
+/* Sends length bytes (or, if length is negative, the rest) of a file,
+ * starting from offset, to an async socket, without passing them through
+ * VM buffers. The file is read through a descriptor of its own, so its
+ * position is not changed, and it may be closed once the task is queued.
+ * Any earlier writes to the socket should have completed before starting
+ * this, as it writes to the socket directly. It fails if the socket takes
+ * no bytes for SENDFILE_STALL_TIMEOUT milliseconds. */
+MVMObject * MVM_io_socket_sendfile_async(MVMThreadContext *tc, MVMObject *socket,
+        MVMObject *queue, MVMObject *schedulee, MVMObject *file, MVMint64 offset,
+        MVMint64 length, MVMObject *async_type) {
+#ifdef _WIN32
+    MVM_exception_throw_adhoc(tc, "asyncsendfile is not supported on this platform");
+#else
+    MVMAsyncTask *task;
+    SendFileInfo *si;
+    MVMint64      in_fd;
+
+    /* Validate what we were given. */
+    if (REPR(socket)->ID != MVM_REPR_ID_MVMOSHandle || !IS_CONCRETE(socket)
+            || ((MVMOSHandle *)socket)->body.ops != &op_table)
+        MVM_exception_throw_adhoc(tc, "asyncsendfile requires an async socket to send to");
+    if (REPR(queue)->ID != MVM_REPR_ID_ConcBlockingQueue)
+        MVM_exception_throw_adhoc(tc,
+            "asyncsendfile target queue must have ConcBlockingQueue REPR");
+    if (REPR(async_type)->ID != MVM_REPR_ID_MVMAsyncTask)
+        MVM_exception_throw_adhoc(tc,
+            "asyncsendfile result type must have REPR AsyncTask");
+    if (offset < 0)
+        MVM_exception_throw_adhoc(tc, "asyncsendfile requires a non-negative offset");
+
+    /* Create async task handle. It owns the file descriptor we duplicate,
+     * so that it is closed even if we throw before the task runs. */
+    MVMROOT4(tc, socket, queue, schedulee, file) {
+        task = (MVMAsyncTask *)MVM_repr_alloc_init(tc, async_type);
+    }
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
+    task->body.ops  = &sendfile_op_table;
+    task->body.loop = socket_loop((MVMOSHandle *)socket);
+    si              = MVM_calloc(1, sizeof(SendFileInfo));
+    MVM_ASSIGN_REF(tc, &(task->common.header), si->handle, socket);
+    si->in_fd       = -1;
+    si->out_fd      = -1;
+    si->offset      = offset;
+    si->length      = length;
+    task->body.data = si;
+    MVMROOT(tc, task) {
+        in_fd = MVM_io_fileno(tc, file);
+    }
+    if (in_fd < 0)
+        MVM_exception_throw_adhoc(tc, "asyncsendfile requires a file handle to send from");
+    if ((si->in_fd = dup((int)in_fd)) < 0)
+        MVM_exception_throw_adhoc(tc, "asyncsendfile failed to duplicate file descriptor: %s",
+            strerror(errno));
+
+    /* Hand the task off to the event loop. */
+    MVMROOT(tc, task) {
+        MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
+    }
+
+    return (MVMObject *)task;
+#endif
+}
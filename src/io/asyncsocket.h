@@ -7,3 +7,6 @@ MVMObject * MVM_io_socket_connect_unix_async(MVMThreadContext *tc, MVMObject *qu
     MVMObject *schedulee, MVMString *path, MVMObject *async_type);
 MVMObject * MVM_io_socket_listen_unix_async(MVMThreadContext *tc, MVMObject *queue,
     MVMObject *schedulee, MVMString *path, MVMint32 backlog, MVMObject *async_type);
+MVMObject * MVM_io_socket_sendfile_async(MVMThreadContext *tc, MVMObject *socket,
+    MVMObject *queue, MVMObject *schedulee, MVMObject *file, MVMint64 offset,
+    MVMint64 length, MVMObject *async_type);
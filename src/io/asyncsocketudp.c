@@ -1,14 +1,29 @@
 #include "moar.h"
 
+#ifdef __linux__
+#include <errno.h>
+#include <sys/socket.h>
+#endif
+
 /* Number of bytes we accept per read. */
 #define CHUNK_SIZE 65536
 
+/* Maximum number of datagrams received (with recvmmsg, where available) or
+ * sent (with sendmmsg) per system call by the batched read and write tasks. */
+#define BATCH_SIZE 16
+
 /* Data that we keep for an asynchronous UDP socket handle. */
 typedef struct {
     /* The libuv handle to the socket. */
     uv_udp_t *handle;
 } MVMIOAsyncUDPSocketData;
 
+/* Gets the event loop the socket's libuv handle lives on; tasks using the
+ * socket must be pinned to it. */
+static MVMEventLoop * socket_loop(MVMOSHandle *h) {
+    return MVM_io_eventloop_of_handle((uv_handle_t *)((MVMIOAsyncUDPSocketData *)h->body.data)->handle);
+}
+
 /* Info we convey about a read task. */
 typedef struct {
     MVMOSHandle      *handle;
@@ -18,11 +33,9 @@ typedef struct {
     int               work_idx;
 } ReadInfo;
 
-/* Allocates a buffer of the suggested size. */
+/* Lends out the event loop's read buffer. */
 static void on_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
-    size_t size = suggested_size > 0 ? suggested_size : 4;
-    buf->base   = MVM_malloc(size);
-    buf->len    = size;
+    MVM_io_eventloop_alloc_read_buffer(handle, suggested_size, buf);
 }
 
 /* Callback used to simply free memory on close. */
@@ -72,6 +85,16 @@ static void push_name_and_port(MVMThreadContext *tc, struct sockaddr_storage *na
     MVM_repr_push_o(tc, arr, port_o);
 }
 
+/* Copies a datagram out of a buffer that stays owned by someone else. */
+static MVMint8 * copy_datagram(const uv_buf_t *buf, ssize_t nread) {
+    MVMint8 *copy = NULL;
+    if (nread > 0) {
+        copy = MVM_malloc(nread);
+        memcpy(copy, buf->base, nread);
+    }
+    return copy;
+}
+
 /* Read handler. */
 static void on_read(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const struct sockaddr *addr, unsigned flags) {
     ReadInfo         *ri  = (ReadInfo *)handle->data;
@@ -85,11 +108,11 @@ static void on_read(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const
      * pass it through to the user. */
 
     if (nread == 0 && addr == NULL) {
-        /* libuv still handed us the buffer on_alloc allocated; free it or we
-         * leak one buffer per received datagram (a large UDP memory leak for
-         * e.g. async DNS scanning). */
-        if (buf && buf->base)
-            MVM_free(buf->base);
+        /* libuv still handed us the buffer on_alloc lent out; give it back
+         * or the loop's read buffer stays lent out (and a fallback buffer
+         * leaks). */
+        if (buf)
+            MVM_io_eventloop_take_read_buffer((uv_handle_t *)handle, buf, 0);
         return;
     }
 
@@ -106,11 +129,19 @@ static void on_read(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const
                 tc->instance->boot_types.BOOTInt, ri->seq_number++);
             MVM_repr_push_o(tc, arr, seq_boxed);
 
-            /* Produce a buffer and push it. */
+            /* Produce a buffer and push it. If libuv used recvmmsg, we're
+             * given a slice of the buffer we lent out, which we only get back
+             * in a later callback, so copy the datagram out of it. */
             res_buf      = (MVMArray *)MVM_repr_alloc_init(tc, ri->buf_type);
-            res_buf->body.slots.i8 = (MVMint8 *)buf->base;
+            if (flags & UV_UDP_MMSG_CHUNK) {
+                res_buf->body.slots.i8 = copy_datagram(buf, nread);
+            }
+            else {
+                res_buf->body.slots.i8 = (MVMint8 *)MVM_io_eventloop_take_read_buffer(
+                    (uv_handle_t *)handle, buf, nread);
+            }
             res_buf->body.start    = 0;
-            res_buf->body.ssize    = buf->len;
+            res_buf->body.ssize    = nread;
             res_buf->body.elems    = nread;
             MVM_repr_push_o(tc, arr, (MVMObject *)res_buf);
 
@@ -131,8 +162,7 @@ static void on_read(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTInt);
         }
-        if (buf->base)
-            MVM_free(buf->base);
+        MVM_io_eventloop_take_read_buffer((uv_handle_t *)handle, buf, 0);
         uv_udp_recv_stop(handle);
         MVM_io_eventloop_remove_active_work(tc, &(ri->work_idx));
     }
@@ -148,8 +178,7 @@ static void on_read(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTInt);
         }
-        if (buf->base)
-            MVM_free(buf->base);
+        MVM_io_eventloop_take_read_buffer((uv_handle_t *)handle, buf, 0);
         uv_udp_recv_stop(handle);
         MVM_io_eventloop_remove_active_work(tc, &(ri->work_idx));
     }
@@ -239,6 +268,7 @@ static MVMAsyncTask * read_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObject
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
     task->body.ops  = &read_op_table;
+    task->body.loop  = socket_loop(h);
     ri              = MVM_calloc(1, sizeof(ReadInfo));
     MVM_ASSIGN_REF(tc, &(task->common.header), ri->buf_type, buf_type);
     MVM_ASSIGN_REF(tc, &(task->common.header), ri->handle, h);
@@ -400,6 +430,7 @@ static MVMAsyncTask * write_bytes_to(MVMThreadContext *tc, MVMOSHandle *h, MVMOb
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
     task->body.ops  = &write_op_table;
+    task->body.loop  = socket_loop(h);
     wi              = MVM_calloc(1, sizeof(WriteInfo));
     MVM_ASSIGN_REF(tc, &(task->common.header), wi->handle, h);
     MVM_ASSIGN_REF(tc, &(task->common.header), wi->buf_data, buffer);
@@ -414,6 +445,363 @@ static MVMAsyncTask * write_bytes_to(MVMThreadContext *tc, MVMOSHandle *h, MVMOb
     return task;
 }
 
+/* Info we convey about a batched read task. */
+typedef struct {
+    MVMOSHandle      *handle;
+    MVMObject        *buf_type;
+    MVMObject        *datagrams;
+    MVMObject        *addresses;
+    char             *buffer;
+    int               seq_number;
+    MVMThreadContext *tc;
+    int               work_idx;
+} BatchReadInfo;
+
+/* Hands out the task's own buffer, with room for a full batch of datagrams;
+ * libuv only uses recvmmsg when given more than one datagram's worth. It's
+ * reused for every batch, since each datagram is copied out of it. */
+static void on_batch_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+    BatchReadInfo *bri = (BatchReadInfo *)handle->data;
+    if (!bri->buffer)
+        bri->buffer = MVM_malloc(BATCH_SIZE * CHUNK_SIZE);
+    buf->base = bri->buffer;
+    buf->len  = BATCH_SIZE * CHUNK_SIZE;
+}
+
+/* Sends the datagrams gathered so far, if any, as a single notification. */
+static void flush_batch(MVMThreadContext *tc, BatchReadInfo *bri, MVMAsyncTask *t) {
+    MVMObject *arr;
+    if (!bri->datagrams)
+        return;
+    MVMROOT(tc, t) {
+        arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+        MVM_repr_push_o(tc, arr, t->body.schedulee);
+        MVMROOT(tc, arr) {
+            MVMObject *seq_boxed = MVM_repr_box_int(tc,
+                tc->instance->boot_types.BOOTInt, bri->seq_number++);
+            MVM_repr_push_o(tc, arr, seq_boxed);
+        }
+        MVM_repr_push_o(tc, arr, bri->datagrams);
+        MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
+        MVM_repr_push_o(tc, arr, bri->addresses);
+        bri->datagrams = NULL;
+        bri->addresses = NULL;
+    }
+    MVM_repr_push_o(tc, t->body.queue, arr);
+}
+
+/* Batched read handler. When libuv uses recvmmsg, it calls this for each
+ * datagram received by one system call with UV_UDP_MMSG_CHUNK set, and then
+ * once more to give the buffer back, at which point we send them all on
+ * together. Otherwise, each datagram is sent on as a batch of its own. */
+static void on_batch_read(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const struct sockaddr *addr, unsigned flags) {
+    BatchReadInfo    *bri = (BatchReadInfo *)handle->data;
+    MVMThreadContext *tc  = bri->tc;
+    MVMAsyncTask     *t   = MVM_io_eventloop_get_active_work(tc, bri->work_idx);
+
+    if (nread == 0 && addr == NULL) {
+        flush_batch(tc, bri, t);
+    }
+    else if (nread >= 0) {
+        MVMROOT(tc, t) {
+            MVMArray *res_buf;
+            if (!bri->datagrams) {
+                MVMObject *datagrams, *addresses;
+                datagrams = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+                MVM_ASSIGN_REF(tc, &(t->common.header), bri->datagrams, datagrams);
+                addresses = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+                MVM_ASSIGN_REF(tc, &(t->common.header), bri->addresses, addresses);
+            }
+
+            /* Copy the datagram out into a buffer of its own. */
+            res_buf = (MVMArray *)MVM_repr_alloc_init(tc, bri->buf_type);
+            res_buf->body.slots.i8 = copy_datagram(buf, nread);
+            res_buf->body.start    = 0;
+            res_buf->body.ssize    = nread;
+            res_buf->body.elems    = nread;
+            MVM_repr_push_o(tc, bri->datagrams, (MVMObject *)res_buf);
+
+            /* Add its address and port. */
+            push_name_and_port(tc, (struct sockaddr_storage *)addr, bri->addresses);
+
+            if (!(flags & UV_UDP_MMSG_CHUNK))
+                flush_batch(tc, bri, t);
+        }
+    }
+    else {
+        MVMObject *arr;
+        MVMROOT(tc, t) {
+            flush_batch(tc, bri, t);
+            arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+            MVM_repr_push_o(tc, arr, t->body.schedulee);
+            MVMROOT(tc, arr) {
+                if (nread == UV_EOF) {
+                    MVMObject *final = MVM_repr_box_int(tc,
+                        tc->instance->boot_types.BOOTInt, bri->seq_number);
+                    MVM_repr_push_o(tc, arr, final);
+                    MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTArray);
+                    MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
+                }
+                else {
+                    MVMString *msg_str = MVM_string_ascii_decode_nt(tc,
+                        tc->instance->VMString, uv_strerror(nread));
+                    MVMObject *msg_box = MVM_repr_box_str(tc,
+                        tc->instance->boot_types.BOOTStr, msg_str);
+                    MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTInt);
+                    MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTArray);
+                    MVM_repr_push_o(tc, arr, msg_box);
+                }
+                MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTArray);
+            }
+        }
+        uv_udp_recv_stop(handle);
+        MVM_io_eventloop_remove_active_work(tc, &(bri->work_idx));
+        MVM_repr_push_o(tc, t->body.queue, arr);
+    }
+}
+
+/* Does setup work for setting up batched asynchronous reads. */
+static void read_batch_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    MVMIOAsyncUDPSocketData *handle_data;
+    int                   r;
+
+    /* Add to work in progress. */
+    BatchReadInfo *bri = (BatchReadInfo *)data;
+    bri->tc            = tc;
+    bri->work_idx      = MVM_io_eventloop_add_active_work(tc, async_task);
+
+    /* Start reading the stream. */
+    handle_data = (MVMIOAsyncUDPSocketData *)bri->handle->body.data;
+    handle_data->handle->data = data;
+    if ((r = uv_udp_recv_start(handle_data->handle, on_batch_alloc, on_batch_read)) < 0) {
+        /* Error; need to notify. */
+        MVMROOT(tc, async_task) {
+            MVMObject    *arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+            MVM_repr_push_o(tc, arr, ((MVMAsyncTask *)async_task)->body.schedulee);
+            MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTInt);
+            MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTArray);
+            MVMROOT(tc, arr) {
+                MVMString *msg_str = MVM_string_ascii_decode_nt(tc,
+                    tc->instance->VMString, uv_strerror(r));
+                MVMObject *msg_box = MVM_repr_box_str(tc,
+                    tc->instance->boot_types.BOOTStr, msg_str);
+                MVM_repr_push_o(tc, arr, msg_box);
+            }
+            MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTArray);
+            MVM_repr_push_o(tc, ((MVMAsyncTask *)async_task)->body.queue, arr);
+        }
+        MVM_io_eventloop_remove_active_work(tc, &(bri->work_idx));
+    }
+}
+
+/* Marks objects for a batched read task. */
+static void read_batch_gc_mark(MVMThreadContext *tc, void *data, MVMGCWorklist *worklist) {
+    BatchReadInfo *bri = (BatchReadInfo *)data;
+    MVM_gc_worklist_add(tc, worklist, &bri->buf_type);
+    MVM_gc_worklist_add(tc, worklist, &bri->handle);
+    MVM_gc_worklist_add(tc, worklist, &bri->datagrams);
+    MVM_gc_worklist_add(tc, worklist, &bri->addresses);
+}
+
+/* Frees info for a batched read task. */
+static void read_batch_gc_free(MVMThreadContext *tc, MVMObject *t, void *data) {
+    if (data) {
+        BatchReadInfo *bri = (BatchReadInfo *)data;
+        MVM_free(bri->buffer);
+        MVM_free(bri);
+    }
+}
+
+/* Operations table for batched async read task. */
+static const MVMAsyncTaskOps read_batch_op_table = {
+    read_batch_setup,
+    NULL,
+    NULL,
+    read_batch_gc_mark,
+    read_batch_gc_free
+};
+
+/* Info we convey about a batched write task. */
+typedef struct {
+    MVMOSHandle      *handle;
+    MVMObject        *datagrams;
+    uv_udp_send_t    *reqs;
+    uv_buf_t         *bufs;
+    MVMuint32         num_datagrams;
+    MVMuint32         sent;
+    MVMuint32         pending;
+    int               error;
+    MVMThreadContext *tc;
+    int               work_idx;
+    struct sockaddr  *dest_addr;
+} BatchWriteInfo;
+
+/* Notifies completion of a batched write, with the number of datagrams
+ * sent, or the first error encountered. */
+static void batch_write_done(MVMThreadContext *tc, BatchWriteInfo *bwi, MVMAsyncTask *t) {
+    MVMObject *arr;
+    MVMROOT(tc, t) {
+        arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+        MVM_repr_push_o(tc, arr, t->body.schedulee);
+        MVMROOT(tc, arr) {
+            if (bwi->error == 0) {
+                MVMObject *sent_box = MVM_repr_box_int(tc,
+                    tc->instance->boot_types.BOOTInt, bwi->sent);
+                MVM_repr_push_o(tc, arr, sent_box);
+                MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
+            }
+            else {
+                MVMString *msg_str = MVM_string_ascii_decode_nt(tc,
+                    tc->instance->VMString, uv_strerror(bwi->error));
+                MVMObject *msg_box = MVM_repr_box_str(tc,
+                    tc->instance->boot_types.BOOTStr, msg_str);
+                MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTInt);
+                MVM_repr_push_o(tc, arr, msg_box);
+            }
+        }
+    }
+    MVM_repr_push_o(tc, t->body.queue, arr);
+    MVM_free_null(bwi->reqs);
+    MVM_free_null(bwi->bufs);
+    MVM_io_eventloop_remove_active_work(tc, &(bwi->work_idx));
+}
+
+/* Completion handler for one datagram of a batched write that went through
+ * libuv's send queue. */
+static void on_batch_write(uv_udp_send_t *req, int status) {
+    BatchWriteInfo   *bwi = (BatchWriteInfo *)req->data;
+    MVMThreadContext *tc  = bwi->tc;
+    if (status < 0) {
+        if (bwi->error == 0)
+            bwi->error = status;
+    }
+    else {
+        bwi->sent++;
+    }
+    if (--bwi->pending == 0)
+        batch_write_done(tc, bwi, MVM_io_eventloop_get_active_work(tc, bwi->work_idx));
+}
+
+#ifdef __linux__
+/* Sends as many of the datagrams as the socket will take right now using
+ * sendmmsg, returning how many that was. This is only done when libuv has
+ * nothing queued for the socket, so as not to send out of order. */
+static MVMuint32 send_batch_now(BatchWriteInfo *bwi, uv_udp_t *handle) {
+    struct mmsghdr msgs[BATCH_SIZE];
+    socklen_t      addr_len = bwi->dest_addr->sa_family == AF_INET6
+        ? sizeof(struct sockaddr_in6)
+        : sizeof(struct sockaddr_in);
+    MVMuint32      done = 0;
+    uv_os_fd_t     fd;
+
+    if (handle->send_queue_count != 0 || uv_fileno((uv_handle_t *)handle, &fd) != 0)
+        return 0;
+    while (done < bwi->num_datagrams) {
+        MVMuint32 i, n = bwi->num_datagrams - done;
+        int r;
+        if (n > BATCH_SIZE)
+            n = BATCH_SIZE;
+        memset(msgs, 0, n * sizeof(struct mmsghdr));
+        for (i = 0; i < n; i++) {
+            /* uv_buf_t is layout-compatible with struct iovec on Unix. */
+            msgs[i].msg_hdr.msg_name    = bwi->dest_addr;
+            msgs[i].msg_hdr.msg_namelen = addr_len;
+            msgs[i].msg_hdr.msg_iov     = (struct iovec *)&(bwi->bufs[done + i]);
+            msgs[i].msg_hdr.msg_iovlen  = 1;
+        }
+        r = sendmmsg(fd, msgs, n, 0);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                bwi->error = uv_translate_sys_error(errno);
+            break;
+        }
+        done += r;
+    }
+    return done;
+}
+#endif
+
+/* Does setup work for a batched asynchronous write. Where sendmmsg is
+ * available, as much as possible is sent with it straight away; whatever
+ * remains goes through libuv's send queue, one request per datagram. */
+static void write_batch_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
+    MVMIOAsyncUDPSocketData *handle_data;
+    MVMuint32                i, done = 0;
+
+    /* Add to work in progress. */
+    BatchWriteInfo *bwi = (BatchWriteInfo *)data;
+    bwi->tc             = tc;
+    bwi->work_idx       = MVM_io_eventloop_add_active_work(tc, async_task);
+
+    handle_data = (MVMIOAsyncUDPSocketData *)bwi->handle->body.data;
+    if (uv_is_closing((uv_handle_t *)handle_data->handle)) {
+        MVM_io_eventloop_remove_active_work(tc, &(bwi->work_idx));
+        MVM_exception_throw_adhoc(tc, "cannot write to a closed socket");
+    }
+
+    /* Point a buffer at each of the datagrams. */
+    bwi->bufs = MVM_malloc((bwi->num_datagrams ? bwi->num_datagrams : 1) * sizeof(uv_buf_t));
+    for (i = 0; i < bwi->num_datagrams; i++) {
+        MVMArray *buffer = (MVMArray *)MVM_repr_at_pos_o(tc, bwi->datagrams, i);
+        bwi->bufs[i] = uv_buf_init((char *)(buffer->body.slots.i8 + buffer->body.start),
+            (unsigned int)buffer->body.elems);
+    }
+
+#ifdef __linux__
+    done = send_batch_now(bwi, handle_data->handle);
+#endif
+    bwi->sent = done;
+
+    /* Queue up whatever is left. */
+    if (bwi->error == 0 && done < bwi->num_datagrams) {
+        bwi->reqs = MVM_malloc((bwi->num_datagrams - done) * sizeof(uv_udp_send_t));
+        for (i = done; i < bwi->num_datagrams; i++) {
+            uv_udp_send_t *req = &(bwi->reqs[i - done]);
+            int r;
+            req->data = bwi;
+            if ((r = uv_udp_send(req, handle_data->handle, &(bwi->bufs[i]), 1,
+                    bwi->dest_addr, on_batch_write)) < 0) {
+                bwi->error = r;
+                break;
+            }
+            bwi->pending++;
+        }
+    }
+
+    /* If nothing was left in flight, we're already done. */
+    if (bwi->pending == 0)
+        batch_write_done(tc, bwi, (MVMAsyncTask *)async_task);
+}
+
+/* Marks objects for a batched write task. */
+static void write_batch_gc_mark(MVMThreadContext *tc, void *data, MVMGCWorklist *worklist) {
+    BatchWriteInfo *bwi = (BatchWriteInfo *)data;
+    MVM_gc_worklist_add(tc, worklist, &bwi->handle);
+    MVM_gc_worklist_add(tc, worklist, &bwi->datagrams);
+}
+
+/* Frees info for a batched write task. */
+static void write_batch_gc_free(MVMThreadContext *tc, MVMObject *t, void *data) {
+    if (data) {
+        BatchWriteInfo *bwi = (BatchWriteInfo *)data;
+        MVM_free(bwi->reqs);
+        MVM_free(bwi->bufs);
+        MVM_free(bwi->dest_addr);
+        MVM_free(bwi);
+    }
+}
+
+/* Operations table for batched async write task. */
+static const MVMAsyncTaskOps write_batch_op_table = {
+    write_batch_setup,
+    NULL,
+    NULL,
+    write_batch_gc_mark,
+    write_batch_gc_free
+};
+
 /* Does an asynchronous close (since it must run on the event loop). */
 static void close_perform(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
     uv_handle_t *handle = (uv_handle_t *)data;
@@ -442,6 +830,7 @@ static MVMint64 close_socket(MVMThreadContext *tc, MVMOSHandle *h) {
             tc->instance->boot_types.BOOTAsync);
     }
     task->body.ops  = &close_op_table;
+    task->body.loop  = socket_loop(h);
     task->body.data = data->handle;
     MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
 
@@ -499,7 +888,10 @@ static void setup_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
     SocketSetupInfo *ssi = (SocketSetupInfo *)data;
     uv_udp_t *udp_handle = MVM_malloc(sizeof(uv_udp_t));
     int r;
-    if ((r = uv_udp_init(loop, udp_handle)) >= 0) {
+    /* Ask for recvmmsg to be used where available; it only kicks in when
+     * the read buffer has room for more than one datagram, which is just
+     * what batched reads provide. */
+    if ((r = uv_udp_init_ex(loop, udp_handle, AF_UNSPEC | UV_UDP_RECVMMSG)) >= 0) {
         if (ssi->bind_addr)
             r = uv_udp_bind(udp_handle, ssi->bind_addr, 0);
         if (r >= 0 && (ssi->flags & 1))
@@ -607,3 +999,119 @@ MVMObject * MVM_io_socket_udp_async(MVMThreadContext *tc, MVMObject *queue,
 
     return (MVMObject *)task;
 }
+
+/* Gets the UDP socket data for a handle, complaining if it isn't one. */
+static MVMIOAsyncUDPSocketData * udp_socket_data(MVMThreadContext *tc, MVMObject *socket, const char *op) {
+    if (REPR(socket)->ID != MVM_REPR_ID_MVMOSHandle || ((MVMOSHandle *)socket)->body.ops != &op_table)
+        MVM_exception_throw_adhoc(tc, "%s requires an asynchronous UDP socket", op);
+    return (MVMIOAsyncUDPSocketData *)((MVMOSHandle *)socket)->body.data;
+}
+
+/* Starts reading datagrams from a UDP socket in batches, each notification
+ * carrying an array of buffers and an array of alternating sender hosts and
+ * ports. */
+MVMObject * MVM_io_socket_udp_read_batch_async(MVMThreadContext *tc, MVMObject *socket,
+        MVMObject *queue, MVMObject *schedulee, MVMObject *buf_type, MVMObject *async_type) {
+    MVMAsyncTask  *task;
+    BatchReadInfo *bri;
+
+    /* Validate REPRs. */
+    udp_socket_data(tc, socket, "asyncudpreadbatch");
+    if (REPR(queue)->ID != MVM_REPR_ID_ConcBlockingQueue)
+        MVM_exception_throw_adhoc(tc,
+            "asyncudpreadbatch target queue must have ConcBlockingQueue REPR");
+    if (REPR(async_type)->ID != MVM_REPR_ID_MVMAsyncTask)
+        MVM_exception_throw_adhoc(tc,
+            "asyncudpreadbatch result type must have REPR AsyncTask");
+    if (REPR(buf_type)->ID == MVM_REPR_ID_VMArray) {
+        MVMint32 slot_type = ((MVMArrayREPRData *)STABLE(buf_type)->REPR_data)->slot_type;
+        if (slot_type != MVM_ARRAY_U8 && slot_type != MVM_ARRAY_I8)
+            MVM_exception_throw_adhoc(tc, "asyncudpreadbatch buffer type must be an array of uint8 or int8");
+    }
+    else {
+        MVM_exception_throw_adhoc(tc, "asyncudpreadbatch buffer type must be an array");
+    }
+
+    /* Create async task handle. */
+    MVMROOT4(tc, queue, schedulee, socket, buf_type) {
+        task = (MVMAsyncTask *)MVM_repr_alloc_init(tc, async_type);
+    }
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
+    task->body.ops  = &read_batch_op_table;
+    task->body.loop = socket_loop((MVMOSHandle *)socket);
+    bri             = MVM_calloc(1, sizeof(BatchReadInfo));
+    MVM_ASSIGN_REF(tc, &(task->common.header), bri->buf_type, buf_type);
+    MVM_ASSIGN_REF(tc, &(task->common.header), bri->handle, socket);
+    task->body.data = bri;
+
+    /* Hand the task off to the event loop. */
+    MVMROOT(tc, task) {
+        MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
+    }
+
+    return (MVMObject *)task;
+}
+
+/* Sends a list of buffers as datagrams to the specified host and port,
+ * notifying once with the number sent. */
+MVMObject * MVM_io_socket_udp_write_batch_async(MVMThreadContext *tc, MVMObject *socket,
+        MVMObject *queue, MVMObject *schedulee, MVMObject *datagrams, MVMString *host,
+        MVMint64 port, MVMObject *async_type) {
+    MVMAsyncTask    *task;
+    BatchWriteInfo  *bwi;
+    MVMObject       *snapshot;
+    struct sockaddr *dest_addr;
+    MVMint64         i, num_datagrams;
+
+    /* Validate REPRs. */
+    udp_socket_data(tc, socket, "asyncudpwritebatch");
+    if (REPR(queue)->ID != MVM_REPR_ID_ConcBlockingQueue)
+        MVM_exception_throw_adhoc(tc,
+            "asyncudpwritebatch target queue must have ConcBlockingQueue REPR");
+    if (REPR(async_type)->ID != MVM_REPR_ID_MVMAsyncTask)
+        MVM_exception_throw_adhoc(tc,
+            "asyncudpwritebatch result type must have REPR AsyncTask");
+    if (!IS_CONCRETE(datagrams) || REPR(datagrams)->ID != MVM_REPR_ID_VMArray)
+        MVM_exception_throw_adhoc(tc, "asyncudpwritebatch requires a list of buffers");
+    num_datagrams = MVM_repr_elems(tc, datagrams);
+    for (i = 0; i < num_datagrams; i++) {
+        MVMObject *buffer = MVM_repr_at_pos_o(tc, datagrams, i);
+        if (!IS_CONCRETE(buffer) || REPR(buffer)->ID != MVM_REPR_ID_VMArray
+                || (((MVMArrayREPRData *)STABLE(buffer)->REPR_data)->slot_type != MVM_ARRAY_U8
+                    && ((MVMArrayREPRData *)STABLE(buffer)->REPR_data)->slot_type != MVM_ARRAY_I8))
+            MVM_exception_throw_adhoc(tc,
+                "asyncudpwritebatch requires native arrays of uint8 or int8 to send");
+    }
+
+    /* Take a snapshot of the list, so changes to it don't affect the send. */
+    MVMROOT6(tc, socket, queue, schedulee, datagrams, async_type, host) {
+        snapshot = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
+        MVMROOT(tc, snapshot) {
+            for (i = 0; i < num_datagrams; i++)
+                MVM_repr_push_o(tc, snapshot, MVM_repr_at_pos_o(tc, datagrams, i));
+
+            /* Resolve destination and create async task handle. */
+            dest_addr = MVM_io_resolve_host_name(tc, host, port, MVM_SOCKET_FAMILY_UNSPEC,
+                MVM_SOCKET_TYPE_DGRAM, MVM_SOCKET_PROTOCOL_ANY, 0);
+            task = (MVMAsyncTask *)MVM_repr_alloc_init(tc, async_type);
+        }
+    }
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
+    MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
+    task->body.ops     = &write_batch_op_table;
+    task->body.loop    = socket_loop((MVMOSHandle *)socket);
+    bwi                = MVM_calloc(1, sizeof(BatchWriteInfo));
+    MVM_ASSIGN_REF(tc, &(task->common.header), bwi->handle, socket);
+    MVM_ASSIGN_REF(tc, &(task->common.header), bwi->datagrams, snapshot);
+    bwi->num_datagrams = (MVMuint32)num_datagrams;
+    bwi->dest_addr     = dest_addr;
+    task->body.data    = bwi;
+
+    /* Hand the task off to the event loop. */
+    MVMROOT(tc, task) {
+        MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
+    }
+
+    return (MVMObject *)task;
+}
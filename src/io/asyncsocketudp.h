@@ -2,3 +2,8 @@ MVMObject * MVM_io_socket_udp_async(MVMThreadContext *tc, MVMObject *queue,
                                     MVMObject *schedulee, MVMString *host,
                                     MVMint64 port, MVMint64 flags,
                                     MVMObject *async_type);
+MVMObject * MVM_io_socket_udp_read_batch_async(MVMThreadContext *tc, MVMObject *socket,
+        MVMObject *queue, MVMObject *schedulee, MVMObject *buf_type, MVMObject *async_type);
+MVMObject * MVM_io_socket_udp_write_batch_async(MVMThreadContext *tc, MVMObject *socket,
+        MVMObject *queue, MVMObject *schedulee, MVMObject *datagrams, MVMString *host,
+        MVMint64 port, MVMObject *async_type);
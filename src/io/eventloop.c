@@ -7,12 +7,18 @@
  * started in the usual way, but never actually ends up in interpreter;
  * instead, it enters a libuv event loop "forever", until program exit.
  *
+ * There may be a pool of such loops (MVM_EVENT_LOOPS sets how many), so that
+ * the work of many sockets and other handles is spread over several threads.
+ * Each async task is pinned to one loop: either the one that its handle lives
+ * on, or else one picked round-robin when it is first queued.
+ *
  * Work is sent to the event loop by
  */
 
 /* Sets up an async task to be done on the loop. */
 static void setup_work(MVMThreadContext *tc) {
-    MVMConcBlockingQueue *queue = (MVMConcBlockingQueue *)tc->instance->event_loop_todo_queue;
+    MVMEventLoop         *el    = tc->event_loop;
+    MVMConcBlockingQueue *queue = (MVMConcBlockingQueue *)el->todo_queue;
     MVMObject *task_obj;
 
     MVMROOT(tc, queue) {
@@ -21,7 +27,7 @@ static void setup_work(MVMThreadContext *tc) {
             MVM_ASSERT_NOT_FROMSPACE(tc, task);
             if (task->body.state == MVM_ASYNC_TASK_STATE_NEW) {
                 MVMROOT(tc, task) {
-                    task->body.ops->setup(tc, tc->instance->event_loop, task_obj, task->body.data);
+                    task->body.ops->setup(tc, el->loop, task_obj, task->body.data);
                     task->body.state = MVM_ASYNC_TASK_STATE_SETUP;
                 }
             }
@@ -31,7 +37,8 @@ static void setup_work(MVMThreadContext *tc) {
 
 /* Performs an async emit permit grant on the loop. */
 static void permit_work(MVMThreadContext *tc) {
-    MVMConcBlockingQueue *queue = (MVMConcBlockingQueue *)tc->instance->event_loop_permit_queue;
+    MVMEventLoop         *el    = tc->event_loop;
+    MVMConcBlockingQueue *queue = (MVMConcBlockingQueue *)el->permit_queue;
     MVMObject *task_arr;
 
     MVMROOT(tc, queue) {
@@ -42,7 +49,7 @@ static void permit_work(MVMThreadContext *tc) {
             if (task->body.ops->permit) {
                 MVMint64 channel = MVM_repr_get_int(tc, MVM_repr_at_pos_o(tc, task_arr, 1));
                 MVMint64 permit = MVM_repr_get_int(tc, MVM_repr_at_pos_o(tc, task_arr, 2));
-                task->body.ops->permit(tc, tc->instance->event_loop, task_obj, task->body.data, channel, permit);
+                task->body.ops->permit(tc, el->loop, task_obj, task->body.data, channel, permit);
             }
         }
     }
@@ -50,7 +57,8 @@ static void permit_work(MVMThreadContext *tc) {
 
 /* Performs an async cancellation on the loop. */
 static void cancel_work(MVMThreadContext *tc) {
-    MVMConcBlockingQueue *queue = (MVMConcBlockingQueue *)tc->instance->event_loop_cancel_queue;
+    MVMEventLoop         *el    = tc->event_loop;
+    MVMConcBlockingQueue *queue = (MVMConcBlockingQueue *)el->cancel_queue;
     MVMObject *task_obj;
 
     MVMROOT(tc, queue) {
@@ -60,7 +68,7 @@ static void cancel_work(MVMThreadContext *tc) {
             if (task->body.state == MVM_ASYNC_TASK_STATE_SETUP) {
                 MVMROOT(tc, task) {
                     if (task->body.ops->cancel)
-                        task->body.ops->cancel(tc, tc->instance->event_loop, task_obj, task->body.data);
+                        task->body.ops->cancel(tc, el->loop, task_obj, task->body.data);
                 }
             }
             task->body.state = MVM_ASYNC_TASK_STATE_CANCELLED;
@@ -78,30 +86,43 @@ static void async_handler(uv_async_t *handle) {
     cancel_work(tc);
 }
 
-/* Enters the event loop. */
+/* Enters an event loop; the thread finds which one of the pool it is to run
+ * by looking for its own thread object. */
 static void enter_loop(MVMThreadContext *tc, MVMArgs arg_info) {
-    uv_loop_t    *loop = tc->instance->event_loop;
-    uv_async_t   *async = tc->instance->event_loop_wakeup;
+    MVMInstance  *instance = tc->instance;
+    MVMEventLoop *el       = NULL;
+    MVMuint32     i;
 
 #ifdef MVM_HAS_PTHREAD_SETNAME_NP
     pthread_setname_np(pthread_self(), "async io thread");
 #endif
 
-    /* Bind the thread context for the wakeup signal */
-    async->data = tc;
+    for (i = 0; i < instance->num_event_loops; i++) {
+        if (instance->event_loops[i].thread == (MVMObject *)tc->thread_obj) {
+            el = &instance->event_loops[i];
+            break;
+        }
+    }
+    if (!el)
+        MVM_panic(1, "Event loop thread could not find its event loop");
+
+    /* Bind the thread context for the wakeup signal, and note the loop this
+     * thread runs so that tasks set up on it can find its state. */
+    el->wakeup->data = tc;
+    tc->event_loop   = el;
 
     /* Enter event loop */
-    uv_run(loop, UV_RUN_DEFAULT);
+    uv_run(el->loop, UV_RUN_DEFAULT);
 }
 
-/* Sees if we have an event loop processing thread set up already, and
- * sets it up if not. */
+/* Sees if we have the event loop processing threads set up already, and
+ * sets them up if not. */
 void MVM_io_eventloop_start(MVMThreadContext *tc) {
     MVMInstance *instance = tc->instance;
-    MVMObject *loop_runner;
     unsigned int interval_id;
+    MVMuint32 i;
 
-    if (instance->event_loop_thread)
+    if (instance->event_loops[0].thread)
         return;
 
     /* Grab starting mutex and ensure we didn't lose the race. */
@@ -112,54 +133,78 @@ void MVM_io_eventloop_start(MVMThreadContext *tc) {
 
     interval_id = MVM_telemetry_interval_start(tc, "creating the event loop thread");
 
-    /* We may have lost the race, so we need to setup state carefully */
-    /* This may also be present if this is a thread restart */
-    if (!instance->event_loop) {
-        /* The underlying loop structure that will handle all IO events. */
-        instance->event_loop              = MVM_malloc(sizeof(uv_loop_t));
-        if (uv_loop_init(instance->event_loop) < 0)
-            MVM_panic(1, "Unable to initialize event loop");
-
-        /* The async signal handler for waking up the thread */
-        instance->event_loop_wakeup       = MVM_malloc(sizeof(uv_async_t));
-        if (uv_async_init(instance->event_loop, instance->event_loop_wakeup, async_handler) != 0)
-            MVM_panic(1, "Unable to initialize async wake-up handle for event loop");
-
-        /* Create various bits of state the async event loop thread needs. */
-        instance->event_loop_todo_queue   = MVM_repr_alloc_init(tc,
-            instance->boot_types.BOOTQueue);
-        instance->event_loop_permit_queue = MVM_repr_alloc_init(tc,
-            instance->boot_types.BOOTQueue);
-        instance->event_loop_cancel_queue = MVM_repr_alloc_init(tc,
-            instance->boot_types.BOOTQueue);
-        instance->event_loop_active       = MVM_repr_alloc_init(tc,
-            instance->boot_types.BOOTArray);
-        instance->event_loop_free_indices = MVM_repr_alloc_init(tc,
-            instance->boot_types.BOOTIntArray);
-    }
+    for (i = 0; i < instance->num_event_loops; i++) {
+        MVMEventLoop *el = &instance->event_loops[i];
+
+        /* We may have lost the race, so we need to setup state carefully */
+        /* This may also be present if this is a thread restart */
+        if (!el->loop) {
+            /* The underlying loop structure that will handle all IO events. */
+            el->loop = MVM_malloc(sizeof(uv_loop_t));
+            if (uv_loop_init(el->loop) < 0)
+                MVM_panic(1, "Unable to initialize event loop");
+            el->loop->data = el;
+
+            /* The async signal handler for waking up the thread */
+            el->wakeup = MVM_malloc(sizeof(uv_async_t));
+            if (uv_async_init(el->loop, el->wakeup, async_handler) != 0)
+                MVM_panic(1, "Unable to initialize async wake-up handle for event loop");
+
+            /* Create various bits of state the async event loop thread needs. */
+            el->todo_queue   = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTQueue);
+            el->permit_queue = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTQueue);
+            el->cancel_queue = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTQueue);
+            el->active       = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTArray);
+            el->free_indices = MVM_repr_alloc_init(tc,
+                instance->boot_types.BOOTIntArray);
+        }
 
-    if (!instance->event_loop_thread) {
-        /* Start the event loop thread, which will call a C function that
-         * sits in the uv loop, never leaving until it is stopped from the
-         * outside */
-        loop_runner = MVM_repr_alloc_init(tc, instance->boot_types.BOOTCCode);
-        ((MVMCFunction *)loop_runner)->body.func = enter_loop;
+        if (!el->thread) {
+            /* Start the event loop thread, which will call a C function that
+             * sits in the uv loop, never leaving until it is stopped from the
+             * outside */
+            MVMObject *loop_runner = MVM_repr_alloc_init(tc, instance->boot_types.BOOTCCode);
+            ((MVMCFunction *)loop_runner)->body.func = enter_loop;
 
-        instance->event_loop_thread = MVM_thread_new(tc, loop_runner, 1);
-        MVM_thread_run(tc, instance->event_loop_thread);
+            el->thread = MVM_thread_new(tc, loop_runner, 1);
+            MVM_thread_run(tc, el->thread);
+        }
     }
 
     MVM_telemetry_interval_stop(tc, interval_id, "created the event loop thread");
     uv_mutex_unlock(&instance->mutex_event_loop);
 }
 
+/* Picks an event loop from the pool, round-robin. */
+MVMEventLoop * MVM_io_eventloop_pick(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    if (instance->num_event_loops == 1)
+        return &instance->event_loops[0];
+    return &instance->event_loops[
+        (MVMuint32)MVM_incr(&instance->event_loop_next) % instance->num_event_loops];
+}
+
+/* Gets the event loop a task is pinned to, pinning it to one picked
+ * round-robin if it isn't yet. */
+static MVMEventLoop * loop_for_task(MVMThreadContext *tc, MVMAsyncTask *task) {
+    if (!task->body.loop)
+        task->body.loop = MVM_io_eventloop_pick(tc);
+    return task->body.loop;
+}
+
 
 /* Adds a work item into the event loop work queue. */
 void MVM_io_eventloop_queue_work(MVMThreadContext *tc, MVMObject *work) {
     MVMROOT(tc, work) {
+        MVMEventLoop *el;
         MVM_io_eventloop_start(tc);
-        MVM_repr_push_o(tc, tc->instance->event_loop_todo_queue, work);
-        uv_async_send(tc->instance->event_loop_wakeup);
+        el = loop_for_task(tc, (MVMAsyncTask *)work);
+        MVM_repr_push_o(tc, el->todo_queue, work);
+        uv_async_send(el->wakeup);
     }
 }
 
@@ -175,6 +220,7 @@ void MVM_io_eventloop_permit(MVMThreadContext *tc, MVMObject *task_obj,
             MVMObject *permits_box = NULL;
             MVMObject *arr = NULL;
             MVMROOT3(tc, channel_box, permits_box, arr) {
+                MVMEventLoop *el;
                 channel_box = MVM_repr_box_int(tc, tc->instance->boot_types.BOOTInt, channel);
                 permits_box = MVM_repr_box_int(tc, tc->instance->boot_types.BOOTInt, permits);
                 arr = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTArray);
@@ -182,8 +228,9 @@ void MVM_io_eventloop_permit(MVMThreadContext *tc, MVMObject *task_obj,
                 MVM_repr_push_o(tc, arr, channel_box);
                 MVM_repr_push_o(tc, arr, permits_box);
                 MVM_io_eventloop_start(tc);
-                MVM_repr_push_o(tc, tc->instance->event_loop_permit_queue, arr);
-                uv_async_send(tc->instance->event_loop_wakeup);
+                el = loop_for_task(tc, (MVMAsyncTask *)task_obj);
+                MVM_repr_push_o(tc, el->permit_queue, arr);
+                uv_async_send(el->wakeup);
             }
         }
     }
@@ -204,9 +251,11 @@ void MVM_io_eventloop_cancel_work(MVMThreadContext *tc, MVMObject *task_obj,
                 notify_schedulee);
         }
         MVMROOT(tc, task_obj) {
+            MVMEventLoop *el;
             MVM_io_eventloop_start(tc);
-            MVM_repr_push_o(tc, tc->instance->event_loop_cancel_queue, task_obj);
-            uv_async_send(tc->instance->event_loop_wakeup);
+            el = loop_for_task(tc, (MVMAsyncTask *)task_obj);
+            MVM_repr_push_o(tc, el->cancel_queue, task_obj);
+            uv_async_send(el->wakeup);
         }
     }
     else {
@@ -222,20 +271,23 @@ void MVM_io_eventloop_send_cancellation_notification(MVMThreadContext *tc, MVMAs
         MVM_repr_push_o(tc, notify_queue, notify_schedulee);
 }
 
-/* Adds a work item to the active async task set. */
+/* Adds a work item to the active async task set of the event loop that the
+ * current thread runs. */
 int MVM_io_eventloop_add_active_work(MVMThreadContext *tc, MVMObject *async_task) {
-    MVMuint64 work_idx = MVM_repr_elems(tc, tc->instance->event_loop_free_indices) > 0
-        ? (MVMuint64)MVM_repr_pop_i(tc, tc->instance->event_loop_free_indices)
-        : MVM_repr_elems(tc, tc->instance->event_loop_active);
+    MVMEventLoop *el = tc->event_loop;
+    MVMuint64 work_idx = MVM_repr_elems(tc, el->free_indices) > 0
+        ? (MVMuint64)MVM_repr_pop_i(tc, el->free_indices)
+        : MVM_repr_elems(tc, el->active);
     MVM_ASSERT_NOT_FROMSPACE(tc, async_task);
-    MVM_repr_bind_pos_o(tc, tc->instance->event_loop_active, work_idx, async_task);
+    MVM_repr_bind_pos_o(tc, el->active, work_idx, async_task);
     return work_idx;
 }
 
 /* Gets an active work item from the active work eventloop. */
 MVMAsyncTask * MVM_io_eventloop_get_active_work(MVMThreadContext *tc, int work_idx) {
-    if (work_idx >= 0 && work_idx < (int)MVM_repr_elems(tc, tc->instance->event_loop_active)) {
-        MVMObject *task_obj = MVM_repr_at_pos_o(tc, tc->instance->event_loop_active, work_idx);
+    MVMEventLoop *el = tc->event_loop;
+    if (work_idx >= 0 && work_idx < (int)MVM_repr_elems(tc, el->active)) {
+        MVMObject *task_obj = MVM_repr_at_pos_o(tc, el->active, work_idx);
         if (REPR(task_obj)->ID != MVM_REPR_ID_MVMAsyncTask)
             MVM_panic(1, "non-AsyncTask fetched from eventloop active work list");
         MVM_ASSERT_NOT_FROMSPACE(tc, task_obj);
@@ -250,11 +302,12 @@ MVMAsyncTask * MVM_io_eventloop_get_active_work(MVMThreadContext *tc, int work_i
  * memory associated with it to be collected. Replaces the work index with -1
  * so that any future use of the task will be a failed lookup. */
 void MVM_io_eventloop_remove_active_work(MVMThreadContext *tc, int *work_idx_to_clear) {
+    MVMEventLoop *el = tc->event_loop;
     int work_idx = *work_idx_to_clear;
-    if (work_idx >= 0 && work_idx < (int)MVM_repr_elems(tc, tc->instance->event_loop_active)) {
+    if (work_idx >= 0 && work_idx < (int)MVM_repr_elems(tc, el->active)) {
         *work_idx_to_clear = -1;
-        MVM_repr_bind_pos_o(tc, tc->instance->event_loop_active, work_idx, tc->instance->VMNull);
-        MVM_repr_push_i(tc, tc->instance->event_loop_free_indices, work_idx);
+        MVM_repr_bind_pos_o(tc, el->active, work_idx, tc->instance->VMNull);
+        MVM_repr_push_i(tc, el->free_indices, work_idx);
     }
     else {
         MVM_panic(1, "cannot remove invalid eventloop work item index %d", work_idx);
@@ -266,43 +319,133 @@ void MVM_io_eventloop_remove_active_work(MVMThreadContext *tc, int *work_idx_to_
 /* Send the stop signal - no synchronization required */
 void MVM_io_eventloop_stop(MVMThreadContext *tc) {
     MVMInstance *instance = tc->instance;
-    if (!instance->event_loop_thread)
-        return;
-    /* Stop the loop */
-    uv_stop(instance->event_loop);
-    uv_async_send(instance->event_loop_wakeup);
+    MVMuint32 i;
+    for (i = 0; i < instance->num_event_loops; i++) {
+        MVMEventLoop *el = &instance->event_loops[i];
+        if (!el->thread)
+            continue;
+        /* Stop the loop */
+        uv_stop(el->loop);
+        uv_async_send(el->wakeup);
+    }
 }
 
 /* Wait for exit (again, no synchronizaiton required) */
 void MVM_io_eventloop_join(MVMThreadContext *tc) {
     MVMInstance *instance = tc->instance;
-    if (!instance->event_loop_thread)
-        return;
-    MVM_thread_join(tc, instance->event_loop_thread);
+    MVMuint32 i;
+    for (i = 0; i < instance->num_event_loops; i++)
+        if (instance->event_loops[i].thread)
+            MVM_thread_join(tc, instance->event_loops[i].thread);
+}
+
+/* Forget the event loop threads after they have been stopped and joined, so
+ * that MVM_io_eventloop_start will start new ones. */
+void MVM_io_eventloop_forget_threads(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    MVMuint32 i;
+    for (i = 0; i < instance->num_event_loops; i++)
+        instance->event_loops[i].thread = NULL;
+}
+
+/* Wakes all of the event loop threads, for example so they take part in GC. */
+void MVM_io_eventloop_wakeup_all(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    MVMuint32 i;
+    for (i = 0; i < instance->num_event_loops; i++)
+        if (instance->event_loops[i].wakeup)
+            uv_async_send(instance->event_loops[i].wakeup);
+}
+
+/* Checks whether the current thread is an event loop thread. */
+int MVM_io_eventloop_is_loop_thread(MVMThreadContext *tc, MVMuint32 thread_id) {
+    MVMInstance *instance = tc->instance;
+    MVMuint32 i;
+    for (i = 0; i < instance->num_event_loops; i++) {
+        MVMThread *thread = (MVMThread *)instance->event_loops[i].thread;
+        if (thread && thread->body.tc && thread->body.tc->thread_id == thread_id)
+            return 1;
+    }
+    return 0;
 }
 
 /* Clean up used resources. Synchronization required - other threads might modify them as well */
 void MVM_io_eventloop_destroy(MVMThreadContext *tc) {
     MVMInstance *instance = tc->instance;
+    MVMuint32 i;
     MVM_gc_mark_thread_blocked(tc);
     uv_mutex_lock(&instance->mutex_event_loop);
     MVM_gc_mark_thread_unblocked(tc);
 
-    if (instance->event_loop_thread) {
-        MVM_io_eventloop_stop(tc);
-        MVM_io_eventloop_join(tc);
-        instance->event_loop_thread = NULL;
-    }
+    MVM_io_eventloop_stop(tc);
+    MVM_io_eventloop_join(tc);
+    MVM_io_eventloop_forget_threads(tc);
 
-    if (instance->event_loop) {
-        uv_close((uv_handle_t*)instance->event_loop_wakeup, NULL);
+    for (i = 0; i < instance->num_event_loops; i++) {
+        MVMEventLoop *el = &instance->event_loops[i];
+        if (el->loop) {
+            uv_close((uv_handle_t*)el->wakeup, NULL);
+            MVM_io_timer_wheel_close(tc, el);
 
-        /* Not sure we can always do this */
-        uv_loop_close(instance->event_loop);
+            /* Not sure we can always do this */
+            uv_loop_close(el->loop);
 
-        MVM_free_null(instance->event_loop_wakeup);
-        MVM_free_null(instance->event_loop);
+            MVM_free_null(el->wakeup);
+            MVM_free_null(el->loop);
+            MVM_free_null(el->read_buffer);
+            MVM_free_null(el->timers);
+        }
     }
 
     uv_mutex_unlock(&instance->mutex_event_loop);
 }
+
+/* libuv reads on a loop happen one at a time: a buffer is allocated, the read
+ * is done into it, and the read callback is run. So rather than allocating a
+ * buffer of the (usually 64KB) suggested size for every read, and then
+ * keeping all of it alive in the resulting buffer object however little was
+ * read, each loop lends out a single buffer, and the read callback takes a
+ * right-sized copy of what was read. Should the loop's buffer already be
+ * lent out (on some platforms a read may be started before data arrives), a
+ * fresh buffer is allocated instead. */
+void MVM_io_eventloop_alloc_read_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+    MVMEventLoop *el = MVM_io_eventloop_of_handle(handle);
+    if (el && !el->read_buffer_lent && suggested_size <= MVM_EVENT_LOOP_READ_BUFFER_SIZE) {
+        if (!el->read_buffer)
+            el->read_buffer = MVM_malloc(MVM_EVENT_LOOP_READ_BUFFER_SIZE);
+        el->read_buffer_lent = 1;
+        buf->base = el->read_buffer;
+        buf->len  = MVM_EVENT_LOOP_READ_BUFFER_SIZE;
+    }
+    else {
+        size_t size = suggested_size > 0 ? suggested_size : 4;
+        buf->base   = MVM_malloc(size);
+        buf->len    = size;
+    }
+}
+
+/* Takes the data read into a buffer from MVM_io_eventloop_alloc_read_buffer,
+ * returning an allocation of exactly nread bytes holding it, which the caller
+ * then owns; NULL is returned if nothing was read. Either way, the buffer is
+ * given back, so this must be called once for every buffer handed out, also
+ * on EOF and errors. */
+char * MVM_io_eventloop_take_read_buffer(uv_handle_t *handle, const uv_buf_t *buf, ssize_t nread) {
+    MVMEventLoop *el = MVM_io_eventloop_of_handle(handle);
+    char *data = NULL;
+    if (!buf->base)
+        return NULL;
+    if (el && buf->base == el->read_buffer) {
+        if (nread > 0) {
+            data = MVM_malloc(nread);
+            memcpy(data, buf->base, nread);
+        }
+        el->read_buffer_lent = 0;
+    }
+    else if (nread > 0) {
+        data = (size_t)nread < buf->len ? MVM_realloc(buf->base, nread) : buf->base;
+    }
+    else {
+        MVM_free(buf->base);
+    }
+    return data;
+}
@@ -1,3 +1,41 @@
+/* Upper limit on the number of event loops MVM_EVENT_LOOPS can ask for. */
+#define MVM_EVENT_LOOPS_MAX 256
+
+/* Size of the buffer each event loop lends out to socket reads. */
+#define MVM_EVENT_LOOP_READ_BUFFER_SIZE 65536
+
+/* An event loop in the instance's pool: the libuv loop, the thread running
+ * it, and the state that thread works from. */
+struct MVMEventLoop {
+    /* The thread running the loop, once started. */
+    MVMObject *thread;
+
+    /* The libuv loop; its data points back to this struct. */
+    uv_loop_t *loop;
+
+    /* Async handle used to wake the loop up when there's work for it. */
+    uv_async_t *wakeup;
+
+    /* Concurrent queues of tasks to set up, emit permits to grant, and
+     * tasks to cancel. */
+    MVMObject *todo_queue;
+    MVMObject *permit_queue;
+    MVMObject *cancel_queue;
+
+    /* Tasks active on this loop, to keep them GC marked, and free slots in
+     * that list. */
+    MVMObject *active;
+    MVMObject *free_indices;
+
+    /* Buffer lent out to reads on this loop, allocated on first use, and
+     * whether it is currently lent out. */
+    char *read_buffer;
+    int   read_buffer_lent;
+
+    /* The wheel that timers on this loop are kept on, created on first use. */
+    MVMTimerWheel *timers;
+};
+
 /* Operations table for a certain type of asynchronous task that can be run on
  * the event loop. */
 struct MVMAsyncTaskOps {
@@ -29,7 +67,21 @@ int MVM_io_eventloop_add_active_work(MVMThreadContext *tc, MVMObject *async_task
 MVMAsyncTask * MVM_io_eventloop_get_active_work(MVMThreadContext *tc, int work_idx);
 void MVM_io_eventloop_remove_active_work(MVMThreadContext *tc, int *work_idx_to_clear);
 
+MVMEventLoop * MVM_io_eventloop_pick(MVMThreadContext *tc);
+int MVM_io_eventloop_is_loop_thread(MVMThreadContext *tc, MVMuint32 thread_id);
+void MVM_io_eventloop_wakeup_all(MVMThreadContext *tc);
+
 void MVM_io_eventloop_start(MVMThreadContext *tc);
 void MVM_io_eventloop_stop(MVMThreadContext *tc);
 void MVM_io_eventloop_join(MVMThreadContext *tc);
+void MVM_io_eventloop_forget_threads(MVMThreadContext *tc);
 void MVM_io_eventloop_destroy(MVMThreadContext *tc);
+
+void MVM_io_eventloop_alloc_read_buffer(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf);
+char * MVM_io_eventloop_take_read_buffer(uv_handle_t *handle, const uv_buf_t *buf, ssize_t nread);
+
+/* Gets the event loop that a libuv handle was set up on, so that tasks using
+ * the handle can be pinned to it. */
+MVM_STATIC_INLINE MVMEventLoop * MVM_io_eventloop_of_handle(uv_handle_t *handle) {
+    return handle ? (MVMEventLoop *)handle->loop->data : NULL;
+}
@@ -1,5 +1,6 @@
 #include "moar.h"
 #include "platform/io.h"
+#include "platform/mmap.h"
 
 #ifndef _WIN32
 #include <sys/types.h>
@@ -441,3 +442,69 @@ MVMString * MVM_file_readlink(MVMThreadContext *tc, MVMString *path) {
 
     return result;
 }
+
+/* Maps a file read-only into memory, and returns a native array of 8-bit
+ * integers of the given type whose elements are the file's bytes, without
+ * reading or copying them. The mapping lives as long as the array and any
+ * views of it; an array that is changed gets its own copy first. */
+MVMObject * MVM_file_map(MVMThreadContext *tc, MVMString *path, MVMObject *buf_type) {
+    MVMArrayREPRData *repr_data;
+    MVMObject *result;
+    uv_fs_t   req;
+    uv_file   fd;
+    MVMuint64 size;
+    void     *block;
+    void     *handle = NULL;
+    char     *path_s;
+
+    if (REPR(buf_type)->ID != MVM_REPR_ID_VMArray)
+        MVM_exception_throw_adhoc(tc, "file map requires a native array type");
+    repr_data = (MVMArrayREPRData *)STABLE(buf_type)->REPR_data;
+    if (!repr_data || (repr_data->slot_type != MVM_ARRAY_U8 && repr_data->slot_type != MVM_ARRAY_I8))
+        MVM_exception_throw_adhoc(tc, "file map requires a native array of uint8 or int8");
+
+    /* Allocate the result up front, so that once the file is mapped nothing
+     * can throw before the array owns the mapping. */
+    MVMROOT(tc, path) {
+        result = MVM_repr_alloc_init(tc, buf_type);
+    }
+    MVMROOT(tc, result) {
+        path_s = MVM_platform_path(tc, path);
+    }
+    if ((fd = uv_fs_open(NULL, &req, path_s, O_RDONLY, 0, NULL)) < 0) {
+        char *waste[] = { path_s, NULL };
+        MVM_exception_throw_adhoc_free(tc, waste, "Failed to open file '%s' to map it: %s",
+            path_s, uv_strerror(req.result));
+    }
+    if (uv_fs_fstat(NULL, &req, fd, NULL) < 0) {
+        char *waste[] = { path_s, NULL };
+        uv_fs_t close_req;
+        uv_fs_close(NULL, &close_req, fd, NULL);
+        MVM_exception_throw_adhoc_free(tc, waste, "Failed to stat file '%s' to map it: %s",
+            path_s, uv_strerror(req.result));
+    }
+    size = req.statbuf.st_size;
+
+    /* Nothing to map for an empty file; it's just an empty array. */
+    if (size == 0) {
+        uv_fs_close(NULL, &req, fd, NULL);
+        MVM_free(path_s);
+        return result;
+    }
+    if (size > SIZE_MAX) {
+        char *waste[] = { path_s, NULL };
+        uv_fs_close(NULL, &req, fd, NULL);
+        MVM_exception_throw_adhoc_free(tc, waste, "File '%s' is too large to map", path_s);
+    }
+
+    block = MVM_platform_map_file(fd, &handle, (size_t)size, 0);
+    uv_fs_close(NULL, &req, fd, NULL);
+    if (!block) {
+        char *waste[] = { path_s, NULL };
+        MVM_exception_throw_adhoc_free(tc, waste, "Failed to map file '%s' into memory", path_s);
+    }
+    MVM_free(path_s);
+
+    MVM_VMArray_attach_mapping(tc, result, block, handle, (size_t)size);
+    return result;
+}
@@ -44,6 +44,7 @@ MVMString * MVM_file_in_libpath(MVMThreadContext *tc, MVMString *orig);
 void MVM_file_link(MVMThreadContext *tc, MVMString *oldpath, MVMString *newpath);
 void MVM_file_symlink(MVMThreadContext *tc, MVMString *oldpath, MVMString *newpath);
 MVMString * MVM_file_readlink(MVMThreadContext *tc, MVMString *path);
+MVMObject * MVM_file_map(MVMThreadContext *tc, MVMString *path, MVMObject *buf_type);
 #ifndef _WIN32
 MVMint64 MVM_are_we_group_member(MVMThreadContext *tc, gid_t group);
 #endif
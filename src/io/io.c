@@ -129,8 +129,7 @@ void MVM_io_read_bytes(MVMThreadContext *tc, MVMObject *oshandle, MVMObject *res
     MVMArrayBody *result_body = &((MVMArray *)result)->body;
 
     /* Free any existing data first. */
-    if (result_body->slots.any)
-        MVM_free(result_body->slots.any);
+    MVM_VMArray_free_storage(tc, result_body);
 
     /* Stash the data in the VMArray. */
     result_body->slots.i8 = (MVMint8 *)buf;
@@ -233,6 +232,26 @@ MVMObject * MVM_io_write_bytes_async(MVMThreadContext *tc, MVMObject *oshandle,
         MVM_exception_throw_adhoc(tc, "Cannot write bytes asynchronously to this kind of handle");
 }
 
+MVMObject * MVM_io_write_vectored_async(MVMThreadContext *tc, MVMObject *oshandle, MVMObject *queue,
+                                       MVMObject *schedulee, MVMObject *list, MVMObject *async_type,
+                                       MVMString *encoding, MVMint64 notify) {
+    MVMOSHandle *handle = verify_is_handle(tc, oshandle, "write buffers asynchronously");
+    if (list == NULL)
+        MVM_exception_throw_adhoc(tc, "Failed to write to filehandle: NULL list given");
+    if (handle->body.ops->async_writable && handle->body.ops->async_writable->write_vectored) {
+        MVMObject *result;
+        MVMROOT6(tc, queue, schedulee, list, async_type, handle, encoding) {
+            uv_mutex_t *mutex = acquire_mutex(tc, handle);
+            result = (MVMObject *)handle->body.ops->async_writable->write_vectored(tc,
+                handle, queue, schedulee, list, async_type, encoding, notify);
+            release_mutex(tc, mutex);
+        }
+        return result;
+    }
+    else
+        MVM_exception_throw_adhoc(tc, "Cannot write buffers asynchronously to this kind of handle");
+}
+
 MVMObject * MVM_io_write_bytes_to_async(MVMThreadContext *tc, MVMObject *oshandle, MVMObject *queue,
                                         MVMObject *schedulee, MVMObject *buffer, MVMObject *async_type,
                                         MVMString *host, MVMint64 port) {
@@ -50,6 +50,9 @@ struct MVMIOAsyncReadable {
 struct MVMIOAsyncWritable {
     MVMAsyncTask * (*write_bytes) (MVMThreadContext *tc, MVMOSHandle *h, MVMObject *queue,
         MVMObject *schedulee, MVMObject *buffer, MVMObject *async_type);
+    MVMAsyncTask * (*write_vectored) (MVMThreadContext *tc, MVMOSHandle *h, MVMObject *queue,
+        MVMObject *schedulee, MVMObject *list, MVMObject *async_type, MVMString *encoding,
+        MVMint64 notify);
 };
 
 /* I/O operations on handles that can do asynchronous writing to a given
@@ -99,6 +102,8 @@ MVMObject * MVM_io_read_bytes_async(MVMThreadContext *tc, MVMObject *oshandle, M
     MVMObject *schedulee, MVMObject *buf_type, MVMObject *async_type);
 MVMObject * MVM_io_write_bytes_async(MVMThreadContext *tc, MVMObject *oshandle, MVMObject *queue,
         MVMObject *schedulee, MVMObject *buffer, MVMObject *async_type);
+MVMObject * MVM_io_write_vectored_async(MVMThreadContext *tc, MVMObject *oshandle, MVMObject *queue,
+    MVMObject *schedulee, MVMObject *list, MVMObject *async_type, MVMString *encoding, MVMint64 notify);
 MVMObject * MVM_io_write_bytes_to_async(MVMThreadContext *tc, MVMObject *oshandle, MVMObject *queue,
         MVMObject *schedulee, MVMObject *buffer, MVMObject *async_type, MVMString *host, MVMint64 port);
 MVMint64 MVM_io_eof(MVMThreadContext *tc, MVMObject *oshandle);
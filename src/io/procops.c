@@ -2,7 +2,6 @@
 #include "platform/time.h"
 #include "platform/fork.h"
 #include "core/jfs64.h"
-#include "bithacks.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -292,7 +291,6 @@ typedef struct {
     ProcessState       state;
     int                using;
     int                merge;
-    size_t             last_read;
 } SpawnInfo;
 
 /* Info we convey about a write task. */
@@ -411,6 +409,13 @@ static const MVMAsyncTaskOps write_op_table = {
     write_gc_free
 };
 
+/* Gets the event loop a process was spawned on; tasks using its handles
+ * must be pinned to it. */
+static MVMEventLoop * process_loop(MVMOSHandle *h) {
+    MVMAsyncTask *spawn_task = (MVMAsyncTask *)((MVMIOAsyncProcessData *)h->body.data)->async_task;
+    return spawn_task ? spawn_task->body.loop : NULL;
+}
+
 static MVMAsyncTask * write_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObject *queue,
                                   MVMObject *schedulee, MVMObject *buffer, MVMObject *async_type) {
     MVMAsyncTask *task;
@@ -436,6 +441,7 @@ static MVMAsyncTask * write_bytes(MVMThreadContext *tc, MVMOSHandle *h, MVMObjec
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
     task->body.ops  = &write_op_table;
+    task->body.loop = process_loop(h);
     wi              = MVM_calloc(1, sizeof(SpawnWriteInfo));
     MVM_ASSIGN_REF(tc, &(task->common.header), wi->handle, h);
     MVM_ASSIGN_REF(tc, &(task->common.header), wi->buf_data, buffer);
@@ -504,6 +510,7 @@ static MVMint64 close_stdin(MVMThreadContext *tc, MVMOSHandle *h) {
         }
         task->body.ops  = &deferred_close_op_table;
         task->body.data = si;
+        task->body.loop = process_loop(h);
         MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
         return 0;
     }
@@ -515,6 +522,7 @@ static MVMint64 close_stdin(MVMThreadContext *tc, MVMOSHandle *h) {
         }
         task->body.ops  = &close_op_table;
         task->body.data = si->stdin_handle;
+        task->body.loop = process_loop(h);
         MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
         si->stdin_handle = NULL;
     }
@@ -533,6 +541,7 @@ static void deferred_close_perform(MVMThreadContext *tc, uv_loop_t *loop, MVMObj
         }
         task->body.ops  = &deferred_close_op_table;
         task->body.data = si;
+        task->body.loop = tc->event_loop;
         MVM_io_eventloop_queue_work(tc, (MVMObject *)task);
         return;
     }
@@ -547,7 +556,7 @@ static MVMObject * get_async_task_handle(MVMThreadContext *tc, MVMOSHandle *h) {
 }
 
 /* IO ops table, for async process, populated with functions. */
-static const MVMIOAsyncWritable proc_async_writable = { write_bytes };
+static const MVMIOAsyncWritable proc_async_writable = { write_bytes, NULL };
 static const MVMIOClosable      closable            = { close_stdin };
 static const MVMIOOps proc_op_table = {
     &closable,
@@ -635,23 +644,9 @@ MVM_STATIC_INLINE void adjust_nursery(MVMThreadContext *tc, size_t read_buffer_s
 }
 
 
-/* Allocates a buffer of the suggested size. */
+/* Lends out the event loop's read buffer. */
 static void on_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
-    SpawnInfo *si = (SpawnInfo *)handle->data;
-    size_t size   = si->last_read ? si->last_read : 64;
-    MVMThreadContext *tc = si->tc;
-
-    if (size < 128) {
-        size = 128;
-    }
-    else {
-        size = MVM_bithacks_next_greater_pow2(size + 1);
-    }
-
-    adjust_nursery(tc, size);
-
-    buf->base = MVM_malloc(size);
-    buf->len  = size;
+    MVM_io_eventloop_alloc_read_buffer(handle, suggested_size, buf);
 }
 
 /* Read functions for stdout/stderr/merged. */
@@ -681,9 +676,10 @@ static void async_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf,
                 MVMObject *buf_type    = MVM_repr_at_key_o(tc, si->callbacks,
                                             tc->instance->str_consts.buf_type);
                 MVMArray  *res_buf     = (MVMArray *)MVM_repr_alloc_init(tc, buf_type);
-                res_buf->body.slots.i8 = (MVMint8 *)buf->base;
+                res_buf->body.slots.i8 = (MVMint8 *)MVM_io_eventloop_take_read_buffer(
+                    (uv_handle_t *)handle, buf, nread);
                 res_buf->body.start    = 0;
-                res_buf->body.ssize    = buf->len;
+                res_buf->body.ssize    = nread;
                 res_buf->body.elems    = nread;
                 MVM_repr_push_o(tc, arr, (MVMObject *)res_buf);
             }
@@ -691,8 +687,8 @@ static void async_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf,
             /* Finally, no error. */
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
 
-            /* Update handle with amount read. */
-            si->last_read = nread;
+            /* Account for the memory the buffer holds. */
+            adjust_nursery(tc, nread);
 
             /* Update permit count, stop reading if we run out. */
             if (*permit > 0) {
@@ -719,8 +715,7 @@ static void async_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf,
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
             MVM_repr_push_o(tc, arr, tc->instance->boot_types.BOOTStr);
         }
-        if (buf->base)
-            MVM_free(buf->base);
+        MVM_io_eventloop_take_read_buffer((uv_handle_t *)handle, buf, 0);
         uv_close((uv_handle_t *)handle, NULL);
         if (--si->using == 0)
             MVM_io_eventloop_remove_active_work(tc, &(si->work_idx));
@@ -736,8 +731,7 @@ static void async_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf,
                 tc->instance->boot_types.BOOTStr, msg_str);
             MVM_repr_push_o(tc, arr, msg_box);
         }
-        if (buf->base)
-            MVM_free(buf->base);
+        MVM_io_eventloop_take_read_buffer((uv_handle_t *)handle, buf, 0);
         uv_close((uv_handle_t *)handle, NULL);
         if (--si->using == 0)
             MVM_io_eventloop_remove_active_work(tc, &(si->work_idx));
@@ -785,6 +779,8 @@ static void spawn_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
     uv_process_options_t process_options = {0};
 #endif
     uv_stdio_container_t process_stdio[3];
+    int stdout_to_close = 0;
+    int stderr_to_close = 0;
 
 #ifdef MVM_DO_PTY_OURSELF
     int fd_pty, fd_tty;
@@ -959,6 +955,8 @@ static void spawn_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
                 process_stdio[1].flags   = UV_INHERIT_FD;
                 process_stdio[1].data.fd = (int)MVM_repr_get_int(tc,
                     MVM_repr_at_key_o(tc, si->callbacks, tc->instance->str_consts.stdout_fd));
+                if (MVM_repr_exists_key(tc, si->callbacks, tc->instance->str_consts.stdout_fd_close))
+                    stdout_to_close = process_stdio[1].data.fd;
             }
             else {
                 process_stdio[1].flags   = UV_INHERIT_FD;
@@ -976,6 +974,8 @@ static void spawn_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
                 process_stdio[2].flags   = UV_INHERIT_FD;
                 process_stdio[2].data.fd = (int)MVM_repr_get_int(tc,
                     MVM_repr_at_key_o(tc, si->callbacks, tc->instance->str_consts.stderr_fd));
+                if (MVM_repr_exists_key(tc, si->callbacks, tc->instance->str_consts.stderr_fd_close))
+                    stderr_to_close = process_stdio[2].data.fd;
             }
             else {
                 process_stdio[2].flags   = UV_INHERIT_FD;
@@ -1013,6 +1013,15 @@ static void spawn_setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_
         close(fd_tty);
 #endif
 
+    /* Once spawned, the child has its own copies of any descriptors its
+     * output was redirected to, so we can close ours if asked to. Where one
+     * is the write end of a pipe to another process, this is what lets that
+     * process see end of file once this one is done. */
+    if (stdout_to_close)
+        close(stdout_to_close);
+    if (stderr_to_close)
+        close(stderr_to_close);
+
     if (spawn_result) {
 #ifdef MVM_DO_PTY_OURSELF
         if (pty_mode)
@@ -1349,6 +1358,23 @@ void MVM_proc_kill_async(MVMThreadContext *tc, MVMObject *handle_obj, MVMint64 s
     MVM_exception_throw_adhoc(tc, "killprocasync requires a process handle");
 }
 
+/* Creates an OS-level pipe, returning the file descriptors of its read and
+ * write ends. Passing them as the stdout_fd of one spawned process and the
+ * stdin_fd of another, with stdout_fd_close and stdin_fd_close set, plumbs
+ * the output of the first straight into the second without it passing
+ * through the VM. */
+MVMObject * MVM_proc_pipe(MVMThreadContext *tc) {
+    MVMObject *result;
+    uv_file fds[2];
+    int r = uv_pipe(fds, 0, 0);
+    if (r < 0)
+        MVM_exception_throw_adhoc(tc, "Failed to create pipe: %s", uv_strerror(r));
+    result = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTIntArray);
+    MVM_repr_push_i(tc, result, fds[0]);
+    MVM_repr_push_i(tc, result, fds[1]);
+    return result;
+}
+
 /* Get the current process ID. */
 MVMint64 MVM_proc_getpid(MVMThreadContext *tc) {
 #ifdef _WIN32
@@ -1518,8 +1544,8 @@ MVMint64 MVM_proc_fork(MVMThreadContext *tc) {
     MVM_io_eventloop_stop(tc);
     MVM_spesh_worker_join(tc);
     MVM_io_eventloop_join(tc);
-    /* Allow MVM_io_eventloop_start to restart the thread if necessary */
-    instance->event_loop_thread = NULL;
+    /* Allow MVM_io_eventloop_start to restart the threads if necessary */
+    MVM_io_eventloop_forget_threads(tc);
 
     /* Do not mark thread blocked as the GC also tries to acquire
      * mutex_threads and it's held only briefly by all holders anyway */
@@ -1532,9 +1558,11 @@ MVMint64 MVM_proc_fork(MVMThreadContext *tc) {
         error = "Program has more than one active thread";
     }
 
-    if (pid == 0 && instance->event_loop) {
-        /* Reinitialize uv_loop_t after fork in child */
-        uv_loop_fork(instance->event_loop);
+    if (pid == 0 && instance->event_loops[0].loop) {
+        /* Reinitialize each uv_loop_t after fork in child */
+        MVMuint32 i;
+        for (i = 0; i < instance->num_event_loops; i++)
+            uv_loop_fork(instance->event_loops[i].loop);
     }
 
     /* Release the thread lock, otherwise we can't start them */
@@ -1545,7 +1573,7 @@ MVMint64 MVM_proc_fork(MVMThreadContext *tc) {
     /* However, locks are nonrecursive, so unlocking is needed prior to
      * restarting the event loop */
     uv_mutex_unlock(&instance->mutex_event_loop);
-    if (instance->event_loop)
+    if (instance->event_loops[0].loop)
         MVM_io_eventloop_start(tc);
 
     if (error != NULL)
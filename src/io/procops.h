@@ -16,6 +16,7 @@ MVMObject * MVM_proc_getenvhash(MVMThreadContext *tc);
 MVMObject * MVM_proc_spawn_async(MVMThreadContext *tc, MVMObject *queue, MVMString *prog,
          MVMObject *args, MVMString *cwd, MVMObject *env, MVMObject *callbacks);
 void MVM_proc_kill_async(MVMThreadContext *tc, MVMObject *handle, MVMint64 signal);
+MVMObject * MVM_proc_pipe(MVMThreadContext *tc);
 MVMint64 MVM_proc_getpid(MVMThreadContext *tc);
 MVMint64 MVM_proc_getppid(MVMThreadContext *tc);
 MVMint64 MVM_proc_rand_i(MVMThreadContext *tc);
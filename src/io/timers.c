@@ -1,81 +1,277 @@
 #include "moar.h"
 
+/* Rather than each timer having a libuv timer of its own, the timers on an
+ * event loop are kept in a hierarchical timer wheel, driven by a single libuv
+ * timer. This makes adding and cancelling a timer O(1) and free of any
+ * allocation, which matters when there are a lot of them (for example, idle
+ * timeouts on many connections), and all timers due at once fire together.
+ *
+ * Time on the wheel passes in ticks of MVM_TIMER_GRANULARITY milliseconds (1
+ * by default); a coarser granularity lets more timers fire together, when the
+ * program can tolerate them being that much late. The wheel has WHEEL_LEVELS
+ * levels of WHEEL_SLOTS slots, each slot spanning WHEEL_SLOTS times as many
+ * ticks as a slot on the level below it. A timer goes on the lowest level
+ * whose span reaches when it is due; when time reaches a slot on a higher
+ * level, its timers cascade to the lower levels, and when it reaches a slot
+ * on the lowest level, its timers fire. */
+#define WHEEL_LEVELS 4
+#define WHEEL_BITS   6
+#define WHEEL_SLOTS  (1 << WHEEL_BITS)
+#define WHEEL_MASK   (WHEEL_SLOTS - 1)
+#define WHEEL_SPAN   ((MVMuint64)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
 /* Info we convey about a timer. */
-typedef struct {
+typedef struct TimerInfo TimerInfo;
+struct TimerInfo {
     int timeout;
     int repeat;
-    uv_timer_t *handle;
     MVMThreadContext *tc;
     int work_idx;
 
-    /* In order to correct for clock drift in repeating timers, we adjust the
-     * repeat interval based on the last time our callback ran. */
-    MVMuint64 now_at_prev_callback;
-} TimerInfo;
+    /* When the timer is next due, in loop time, and the tick that is. To
+     * avoid drift in repeating timers, the next due time is worked out from
+     * the previous one rather than from when the timer actually fired. */
+    MVMuint64 due;
+    MVMuint64 expires;
+
+    /* The wheel the timer is on, if any, and its place there. */
+    MVMTimerWheel *wheel;
+    TimerInfo *prev;
+    TimerInfo *next;
+    MVMuint8 level;
+    MVMuint8 slot;
+};
+
+/* A timer wheel. */
+struct MVMTimerWheel {
+    /* The libuv timer set for the next tick anything happens on. */
+    uv_timer_t handle;
+
+    /* Milliseconds per tick. */
+    MVMuint64 granularity;
+
+    /* The last tick that was processed. */
+    MVMuint64 current;
+
+    /* How many timers are on the wheel. */
+    MVMuint64 num_timers;
+
+    /* The slots, each a list of timers, the last timer in each, and which
+     * are non-empty. */
+    TimerInfo *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    TimerInfo *tails[WHEEL_LEVELS][WHEEL_SLOTS];
+    MVMuint64 occupied[WHEEL_LEVELS];
+};
+
+/* Puts a timer into the slot for its expiry tick, which must not be before
+ * the current one. Timers beyond the reach of the top level go into its
+ * furthest slot, and are placed again when that slot cascades. A timer goes
+ * at the end of its slot, so timers due on the same tick fire in the order
+ * they were placed; ones cascading down from a higher level are placed when
+ * they cascade, so come after any already in the slot they land in. */
+static void place_timer(MVMTimerWheel *w, TimerInfo *ti) {
+    MVMuint64 expires = ti->expires;
+    MVMuint32 level   = 0;
+    MVMuint32 slot;
+    if (expires - w->current >= WHEEL_SPAN)
+        expires = w->current + WHEEL_SPAN - 1;
+    while (level < WHEEL_LEVELS - 1
+            && expires - w->current >= (MVMuint64)1 << (WHEEL_BITS * (level + 1)))
+        level++;
+    slot = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    ti->level = level;
+    ti->slot  = slot;
+    ti->prev  = w->tails[level][slot];
+    ti->next  = NULL;
+    if (ti->prev)
+        ti->prev->next = ti;
+    else
+        w->slots[level][slot] = ti;
+    w->tails[level][slot] = ti;
+    w->occupied[level] |= (MVMuint64)1 << slot;
+}
+
+/* Takes a timer off the slot it is in. */
+static void unplace_timer(MVMTimerWheel *w, TimerInfo *ti) {
+    if (ti->prev)
+        ti->prev->next = ti->next;
+    else
+        w->slots[ti->level][ti->slot] = ti->next;
+    if (ti->next)
+        ti->next->prev = ti->prev;
+    else
+        w->tails[ti->level][ti->slot] = ti->prev;
+    if (!w->slots[ti->level][ti->slot])
+        w->occupied[ti->level] &= ~((MVMuint64)1 << ti->slot);
+    ti->prev = ti->next = NULL;
+}
+
+/* Takes the whole list of timers in a slot, leaving it empty. */
+static TimerInfo * take_slot(MVMTimerWheel *w, MVMuint32 level, MVMuint32 slot) {
+    TimerInfo *list = w->slots[level][slot];
+    w->slots[level][slot] = NULL;
+    w->tails[level][slot] = NULL;
+    w->occupied[level] &= ~((MVMuint64)1 << slot);
+    return list;
+}
+
+/* Finds the next tick after the current one on which a slot that has timers
+ * in it is reached. Must only be called with timers on the wheel. */
+static MVMuint64 next_tick(MVMTimerWheel *w) {
+    MVMuint64 best = (MVMuint64)-1;
+    MVMuint32 level;
+    for (level = 0; level < WHEEL_LEVELS; level++) {
+        MVMuint64 occupied = w->occupied[level];
+        if (occupied) {
+            /* Rotate the bitmap so bit 0 is the slot after the current one. */
+            MVMuint32 shift = WHEEL_BITS * level;
+            MVMuint64 block = w->current >> shift;
+            MVMuint32 start = (block + 1) & WHEEL_MASK;
+            MVMuint64 rotated = start
+                ? (occupied >> start) | (occupied << (WHEEL_SLOTS - start))
+                : occupied;
+            MVMuint64 tick = (block + MVM_FFS(rotated)) << shift;
+            if (tick < best)
+                best = tick;
+        }
+    }
+    return best;
+}
+
+static void wheel_cb(uv_timer_t *handle);
 
-/* Frees the timer's handle memory. */
-static void free_timer(uv_handle_t *handle) {
-    MVM_free(handle);
+/* Sets the libuv timer for the next tick anything happens on, or stops it if
+ * the wheel is empty. */
+static void arm_wheel(MVMTimerWheel *w) {
+    if (w->num_timers) {
+        MVMuint64 due = next_tick(w) * w->granularity;
+        MVMuint64 now = uv_now(w->handle.loop);
+        uv_timer_start(&(w->handle), wheel_cb, due > now ? due - now : 0, 0);
+    }
+    else {
+        uv_timer_stop(&(w->handle));
+    }
+}
+
+/* Adds a timer to the wheel, due at the time in its due field. */
+static void add_timer(MVMTimerWheel *w, TimerInfo *ti) {
+    MVMuint64 expires = (ti->due + w->granularity - 1) / w->granularity;
+    ti->expires = expires > w->current ? expires : w->current + 1;
+    ti->wheel   = w;
+    place_timer(w, ti);
+    w->num_timers++;
+}
+
+/* Removes a timer from the wheel. */
+static void remove_timer(MVMTimerWheel *w, TimerInfo *ti) {
+    unplace_timer(w, ti);
+    ti->wheel = NULL;
+    w->num_timers--;
 }
 
-/* Timer callback; dispatches schedulee to the queue. */
-static void timer_cb(uv_timer_t *handle) {
-    TimerInfo        *ti = (TimerInfo *)handle->data;
+/* Fires a timer, dispatching its schedulee to the queue. */
+static void fire_timer(MVMTimerWheel *w, TimerInfo *ti) {
     MVMThreadContext *tc = ti->tc;
     MVMAsyncTask     *t  = MVM_io_eventloop_get_active_work(tc, ti->work_idx);
     MVM_repr_push_o(tc, t->body.queue, t->body.schedulee);
-    if (!ti->repeat && ti->work_idx >= 0) {
-        /* The timer will only fire once. Having now fired, stop the callback,
-         * clean up the handle, and remove the active work so that we will not
-         * hold on to the callback and its associated memory. */
-        uv_timer_stop(ti->handle);
-        uv_close((uv_handle_t *)ti->handle, free_timer);
+    if (ti->repeat) {
+        /* Schedule the next tick from when this one was due. If we're more
+         * than half an interval late, we must have missed our tick for some
+         * reason; pretend the timing was correct and go from now instead. */
+        MVMuint64 now = uv_now(w->handle.loop);
+        if (now > ti->due && (now - ti->due) * 2 > (MVMuint64)ti->repeat)
+            ti->due = now + ti->repeat;
+        else
+            ti->due += ti->repeat;
+        add_timer(w, ti);
+    }
+    else {
+        /* The timer will only fire once. Having now fired, remove the active
+         * work so that we will not hold on to the callback and its associated
+         * memory. */
         MVM_io_eventloop_remove_active_work(tc, &(ti->work_idx));
     }
-    else if (ti->repeat) {
-        /* To counteract drift, we adjust the time based on the current time. */
-        MVMuint64 prev_now = ti->now_at_prev_callback;
-        MVMuint64 actually_passed = uv_now(handle->loop) - prev_now;
-        MVMint64 diff = actually_passed - ti->repeat;
-        if (diff * 2 > ti->repeat) {
-            /* We must have missed our tick for some reason.
-             * We will just pretend the timing was correct and not
-             * change anything. */
-            diff = 0;
-        }
-        else if (diff * -2 < -(MVMint64)ti->repeat) {
-            /* From the code in libuv's timer.c I think the timer callback
-             * can not be invoked if uv_now is not >= the due time, and the
-             * "clamped timeout" that is used is based on timeout + loop->time.
-             * In any case, even though this should not be possible, it's
-             * probably safe to just do nothing, if it becomes
-             * possible later down the line. */
-             diff = 0;
+}
+
+/* Processes a tick: cascades any higher level slots it reaches, from the top
+ * down, and then fires the timers in the lowest level slot it reaches. */
+static void process_tick(MVMTimerWheel *w, MVMuint64 tick) {
+    TimerInfo *ti;
+    MVMint32 level;
+    w->current = tick;
+    for (level = WHEEL_LEVELS - 1; level > 0; level--) {
+        MVMuint32 shift = WHEEL_BITS * level;
+        if ((tick & (((MVMuint64)1 << shift) - 1)) == 0) {
+            ti = take_slot(w, level, (tick >> shift) & WHEEL_MASK);
+            while (ti) {
+                TimerInfo *next = ti->next;
+                place_timer(w, ti);
+                ti = next;
+            }
         }
-        ti->now_at_prev_callback = uv_now(handle->loop) - diff;
-        uv_timer_start(handle, timer_cb, ti->repeat - diff, 0);
     }
+    ti = take_slot(w, 0, tick & WHEEL_MASK);
+    while (ti) {
+        TimerInfo *next = ti->next;
+        ti->prev = ti->next = NULL;
+        ti->wheel = NULL;
+        w->num_timers--;
+        fire_timer(w, ti);
+        ti = next;
+    }
+}
+
+/* Callback for the wheel's libuv timer; processes every tick up to now that
+ * anything happens on. */
+static void wheel_cb(uv_timer_t *handle) {
+    MVMTimerWheel *w   = (MVMTimerWheel *)handle->data;
+    MVMuint64      now = uv_now(handle->loop) / w->granularity;
+    MVMuint64      tick;
+    while (w->num_timers && (tick = next_tick(w)) <= now)
+        process_tick(w, tick);
+    if (now > w->current)
+        w->current = now;
+    arm_wheel(w);
+}
+
+/* Gets the timer wheel of an event loop, creating it if needed. */
+static MVMTimerWheel * get_wheel(MVMThreadContext *tc, uv_loop_t *loop) {
+    MVMEventLoop *el = (MVMEventLoop *)loop->data;
+    if (!el->timers) {
+        MVMTimerWheel *w = MVM_calloc(1, sizeof(MVMTimerWheel));
+        uv_timer_init(loop, &(w->handle));
+        w->handle.data = w;
+        w->granularity = tc->instance->timer_granularity;
+        w->current     = uv_now(loop) / w->granularity;
+        el->timers     = w;
+    }
+    return el->timers;
 }
 
 /* Sets the timer up on the event loop. */
 static void setup(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
-    TimerInfo *ti = (TimerInfo *)data;
-    ti->handle = MVM_malloc(sizeof(uv_timer_t));
-    uv_timer_init(loop, ti->handle);
-    ti->work_idx     = MVM_io_eventloop_add_active_work(tc, async_task);
-    ti->tc           = tc;
-    ti->handle->data = ti;
-    /* Instead of libuv's own repeating timer functionality, we take care of
-     * restarting the timer on every tick, so that we can correct for drift */
-    uv_timer_start(ti->handle, timer_cb, ti->timeout, 0);
+    TimerInfo     *ti = (TimerInfo *)data;
+    MVMTimerWheel *w  = get_wheel(tc, loop);
+    ti->work_idx = MVM_io_eventloop_add_active_work(tc, async_task);
+    ti->tc       = tc;
+    ti->due      = uv_now(loop) + (ti->timeout > 0 ? ti->timeout : 0);
+    /* Nothing to process on an empty wheel, so bring it up to date, so the
+     * new timer goes in relative to now. */
+    if (!w->num_timers && uv_now(loop) / w->granularity > w->current)
+        w->current = uv_now(loop) / w->granularity;
+    add_timer(w, ti);
+    arm_wheel(w);
 }
 
 /* Stops the timer. */
 static void cancel(MVMThreadContext *tc, uv_loop_t *loop, MVMObject *async_task, void *data) {
     TimerInfo *ti = (TimerInfo *)data;
     if (ti->work_idx >= 0) {
-        uv_timer_stop(ti->handle);
-        uv_close((uv_handle_t *)ti->handle, free_timer);
+        MVMTimerWheel *w = ti->wheel;
+        if (w) {
+            remove_timer(w, ti);
+            arm_wheel(w);
+        }
         MVM_io_eventloop_send_cancellation_notification(ti->tc,
             MVM_io_eventloop_get_active_work(tc, ti->work_idx));
         MVM_io_eventloop_remove_active_work(tc, &(ti->work_idx));
@@ -119,10 +315,9 @@ MVMObject * MVM_io_timer_create(MVMThreadContext *tc, MVMObject *queue,
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.queue, queue);
     MVM_ASSIGN_REF(tc, &(task->common.header), task->body.schedulee, schedulee);
     task->body.ops      = &op_table;
-    timer_info          = MVM_malloc(sizeof(TimerInfo));
+    timer_info          = MVM_calloc(1, sizeof(TimerInfo));
     timer_info->timeout = timeout;
     timer_info->repeat  = repeat;
-    timer_info->now_at_prev_callback = 0;
     task->body.data     = timer_info;
 
     /* Hand the task off to the event loop, which will set up the timer on the
@@ -133,3 +328,10 @@ MVMObject * MVM_io_timer_create(MVMThreadContext *tc, MVMObject *queue,
 
     return (MVMObject *)task;
 }
+
+/* Closes the timer wheel of an event loop, if it has one, as part of tearing
+ * the loop down; the memory is freed once the loop is closed. */
+void MVM_io_timer_wheel_close(MVMThreadContext *tc, MVMEventLoop *el) {
+    if (el->timers)
+        uv_close((uv_handle_t *)&(el->timers->handle), NULL);
+}
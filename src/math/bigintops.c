@@ -73,16 +73,69 @@ static void store_int64_result(MVMThreadContext *tc, MVMP6bigintBody *body, MVMi
         body->u.smallint.value = (MVMint32)result;
     }
     else {
+        /* Allocate just the digits a 64-bit value needs, rather than the
+         * default precision. */
         mp_err err;
         mp_int *i = MVM_malloc(sizeof(mp_int));
-        if ((err = mp_init_i64(i, result)) != MP_OKAY) {
+        if ((err = mp_init_size(i, (64 + MP_DIGIT_BIT - 1) / MP_DIGIT_BIT)) != MP_OKAY) {
             MVM_free(i);
             MVM_exception_throw_adhoc(tc, "Error creating a big integer from a native integer (%"PRIi64"): %s", result, mp_error_to_string(err));
         }
+        mp_set_i64(i, result);
         body->u.bigint = i;
     }
 }
 
+/* Gets the value of a bigint body as an int64, if it fits in one. Values too
+ * big for a smallint but fitting here are common, arising where native 64-bit
+ * arithmetic overflowed into a big integer. */
+static int get_int64_value(const MVMP6bigintBody *body, MVMint64 *value) {
+    if (!MVM_BIGINT_IS_BIG(body)) {
+        *value = body->u.smallint.value;
+        return 1;
+    }
+    if (mp_count_bits(body->u.bigint) <= 63) {
+        *value = mp_get_i64(body->u.bigint);
+        return 1;
+    }
+    return 0;
+}
+
+/* Overflow checked 64-bit arithmetic, for operating on values that fit in
+ * an int64 without going through libtommath. Each returns non-zero if the
+ * result overflowed, in which case it is not stored. */
+MVM_STATIC_INLINE int checked_add(MVMint64 a, MVMint64 b, MVMint64 *result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, result);
+#else
+    if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b))
+        return 1;
+    *result = a + b;
+    return 0;
+#endif
+}
+MVM_STATIC_INLINE int checked_sub(MVMint64 a, MVMint64 b, MVMint64 *result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_sub_overflow(a, b, result);
+#else
+    if ((b > 0 && a < INT64_MIN + b) || (b < 0 && a > INT64_MAX + b))
+        return 1;
+    *result = a - b;
+    return 0;
+#endif
+}
+MVM_STATIC_INLINE int checked_mul(MVMint64 a, MVMint64 b, MVMint64 *result) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, result);
+#else
+    if (a > 0 ? (b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a)
+              : (b > 0 ? a < INT64_MIN / b : a != 0 && b < INT64_MAX / a))
+        return 1;
+    *result = a * b;
+    return 0;
+#endif
+}
+
 /* Stores a bigint in a bigint result body, either as a 32-bit smallint if it
  * is in range, or a big integer if not. Clears and frees the passed bigint if
  * it is not being used. */
@@ -315,15 +368,24 @@ MVMObject * MVM_bigint_##opname(MVMThreadContext *tc, MVMObject *result_type, MV
     return result; \
 }
 
-#define MVM_BIGINT_BINARY_OP_SIMPLE(opname, SMALLINT_OP) \
+/* The fallback is used whenever the operands are not both smallints or the
+ * result is not one. Operands and results that fit into an int64 are still
+ * handled without libtommath, and otherwise the result is allocated with the
+ * number of digits it can need, given by RESULT_DIGITS. */
+#define MVM_BIGINT_BINARY_OP_SIMPLE(opname, SMALLINT_OP, CHECKED_OP, RESULT_DIGITS) \
 void MVM_bigint_fallback_##opname(MVMThreadContext *tc, MVMP6bigintBody *ba, MVMP6bigintBody *bb, \
                                   MVMP6bigintBody *bc) { \
     mp_err err; \
     mp_int *ia, *ib, *ic; \
+    MVMint64 sa, sb, sc; \
+    if (get_int64_value(ba, &sa) && get_int64_value(bb, &sb) && !CHECKED_OP(sa, sb, &sc)) { \
+        store_int64_result(tc, bc, sc); \
+        return; \
+    } \
     ia = force_bigint(tc, ba, 0); \
     ib = force_bigint(tc, bb, 1); \
     ic = MVM_malloc(sizeof(mp_int)); \
-    if ((err = mp_init(ic)) != MP_OKAY) { \
+    if ((err = mp_init_size(ic, RESULT_DIGITS)) != MP_OKAY) { \
         MVM_free(ic); \
         MVM_exception_throw_adhoc(tc, "Error initializing a big integer: %s", mp_error_to_string(err)); \
     } \
@@ -341,28 +403,13 @@ MVMObject * MVM_bigint_##opname(MVMThreadContext *tc, MVMObject *result_type, MV
     ba = get_bigint_body(tc, a); \
     bb = get_bigint_body(tc, b); \
     if (MVM_BIGINT_IS_BIG(ba) || MVM_BIGINT_IS_BIG(bb)) { \
-        mp_err err; \
-        mp_int *ia, *ib, *ic; \
         MVMROOT2(tc, a, b) { \
             result = MVM_repr_alloc_init(tc, result_type);\
         } \
         ba = get_bigint_body(tc, a); \
         bb = get_bigint_body(tc, b); \
         bc = get_bigint_body(tc, result); \
-        ia = force_bigint(tc, ba, 0); \
-        ib = force_bigint(tc, bb, 1); \
-        ic = MVM_malloc(sizeof(mp_int)); \
-        if ((err = mp_init(ic)) != MP_OKAY) { \
-            MVM_free(ic); \
-            MVM_exception_throw_adhoc(tc, "Error initializing a big integer: %s", mp_error_to_string(err)); \
-        } \
-        if ((err = mp_##opname(ia, ib, ic)) != MP_OKAY) { \
-            mp_clear(ic); \
-            MVM_free(ic); \
-            MVM_exception_throw_adhoc(tc, "Error performing %s with big integers: %s", #opname, mp_error_to_string(err)); \
-        } \
-        store_bigint_result(bc, ic); \
-        adjust_nursery(tc, bc); \
+        MVM_bigint_fallback_##opname(tc, ba, bb, bc); \
     } \
     else { \
         MVMint64 sc; \
@@ -419,9 +466,9 @@ MVM_BIGINT_UNARY_OP(neg, { sb = -sa; })
 /* unused */
 /* MVM_BIGINT_UNARY_OP(sqrt) */
 
-MVM_BIGINT_BINARY_OP_SIMPLE(add, { sc = sa + sb; })
-MVM_BIGINT_BINARY_OP_SIMPLE(sub, { sc = sa - sb; })
-MVM_BIGINT_BINARY_OP_SIMPLE(mul, { sc = sa * sb; })
+MVM_BIGINT_BINARY_OP_SIMPLE(add, { sc = sa + sb; }, checked_add, MAX(ia->used, ib->used) + 1)
+MVM_BIGINT_BINARY_OP_SIMPLE(sub, { sc = sa - sb; }, checked_sub, MAX(ia->used, ib->used) + 1)
+MVM_BIGINT_BINARY_OP_SIMPLE(mul, { sc = sa * sb; }, checked_mul, ia->used + ib->used)
 MVM_BIGINT_BINARY_OP(lcm)
 
 MVMObject *MVM_bigint_gcd(MVMThreadContext *tc, MVMObject *result_type, MVMObject *a, MVMObject *b) {
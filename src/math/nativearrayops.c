@@ -0,0 +1,365 @@
+#include "moar.h"
+
+/* Operations that work on all of the elements of a native VMArray or
+ * MultiDimArray at once. Each kernel is a plain loop over a contiguous block
+ * of elements of a single type, which the C compiler is able to vectorize;
+ * doing the same from bytecode costs a dispatch and a bounds check per
+ * element. Integer arithmetic wraps around, as the native int ops do. */
+
+/* A contiguous block of native elements to operate on. */
+typedef struct {
+    void     *elems;
+    MVMint64  count;
+    size_t    elem_size;
+    MVMuint8  slot_type;
+} NativeElems;
+
+/* Gets at the elements of a native array, throwing if it is not one. If they
+ * are to be written, they must be owned by the array. */
+static NativeElems get_elems(MVMThreadContext *tc, MVMObject *arr, MVMint64 writable,
+        const char *what) {
+    NativeElems result;
+    if (!IS_CONCRETE(arr))
+        MVM_exception_throw_adhoc(tc, "%s requires a concrete array", what);
+    if (REPR(arr)->ID == MVM_REPR_ID_VMArray) {
+        MVMArrayREPRData *repr_data = (MVMArrayREPRData *)STABLE(arr)->REPR_data;
+        result.count     = ((MVMArray *)arr)->body.elems;
+        result.elem_size = repr_data->elem_size;
+        result.slot_type = repr_data->slot_type;
+        result.elems     = MVM_VMArray_bulk_elems(tc, arr, writable);
+    }
+    else if (REPR(arr)->ID == MVM_REPR_ID_MultiDimArray) {
+        MVMMultiDimArrayREPRData *repr_data = (MVMMultiDimArrayREPRData *)STABLE(arr)->REPR_data;
+        MVMMultiDimArrayBody     *body      = &((MVMMultiDimArray *)arr)->body;
+        MVMint64 i;
+        if (!repr_data)
+            MVM_exception_throw_adhoc(tc, "%s requires a composed array type", what);
+        result.count = 1;
+        for (i = 0; i < repr_data->num_dimensions; i++)
+            result.count *= body->dimensions[i];
+        result.elem_size = repr_data->elem_size;
+        result.slot_type = repr_data->slot_type;
+        result.elems     = body->slots.any;
+    }
+    else {
+        MVM_exception_throw_adhoc(tc, "%s requires a VMArray or MultiDimArray, got %s",
+            what, REPR(arr)->name);
+    }
+    return result;
+}
+
+/* Checks that elements are of the expected type. */
+static void check_slot_type(MVMThreadContext *tc, NativeElems *e, MVMuint8 slot_type,
+        const char *what) {
+    if (e->slot_type != slot_type)
+        MVM_exception_throw_adhoc(tc, "%s requires an array of %s",
+            what, slot_type == MVM_ARRAY_I64 ? "int64" : "num64");
+}
+
+/* Sets every element of a native int array to the value. */
+void MVM_nativearray_fill_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 value) {
+    NativeElems e = get_elems(tc, arr, 1, "native-array-fill-i");
+    MVMint64 i;
+    switch (e.slot_type) {
+        case MVM_ARRAY_I64:
+        case MVM_ARRAY_U64: {
+            MVMint64 *elems = (MVMint64 *)e.elems;
+            for (i = 0; i < e.count; i++)
+                elems[i] = value;
+            break;
+        }
+        case MVM_ARRAY_I32:
+        case MVM_ARRAY_U32: {
+            MVMint32 *elems = (MVMint32 *)e.elems;
+            for (i = 0; i < e.count; i++)
+                elems[i] = (MVMint32)value;
+            break;
+        }
+        case MVM_ARRAY_I16:
+        case MVM_ARRAY_U16: {
+            MVMint16 *elems = (MVMint16 *)e.elems;
+            for (i = 0; i < e.count; i++)
+                elems[i] = (MVMint16)value;
+            break;
+        }
+        case MVM_ARRAY_I8:
+        case MVM_ARRAY_U8:
+            memset(e.elems, (MVMuint8)value, e.count);
+            break;
+        default:
+            MVM_exception_throw_adhoc(tc,
+                "native-array-fill-i requires an array of 8, 16, 32 or 64 bit integers");
+    }
+}
+
+/* Sets every element of a native num array to the value. */
+void MVM_nativearray_fill_n(MVMThreadContext *tc, MVMObject *arr, MVMnum64 value) {
+    NativeElems e = get_elems(tc, arr, 1, "native-array-fill-n");
+    MVMint64 i;
+    if (e.slot_type == MVM_ARRAY_N64) {
+        MVMnum64 *elems = (MVMnum64 *)e.elems;
+        for (i = 0; i < e.count; i++)
+            elems[i] = value;
+    }
+    else if (e.slot_type == MVM_ARRAY_N32) {
+        MVMnum32 *elems = (MVMnum32 *)e.elems;
+        MVMnum32  v     = (MVMnum32)value;
+        for (i = 0; i < e.count; i++)
+            elems[i] = v;
+    }
+    else {
+        MVM_exception_throw_adhoc(tc,
+            "native-array-fill-n requires an array of 32 or 64 bit nums");
+    }
+}
+
+/* Copies count elements between two native arrays of the same element type,
+ * which may be the same array with overlapping ranges. */
+void MVM_nativearray_copy(MVMThreadContext *tc, MVMObject *dest, MVMint64 dest_offset,
+        MVMObject *src, MVMint64 src_offset, MVMint64 count) {
+    NativeElems d = get_elems(tc, dest, 1, "native-array-copy");
+    NativeElems s = get_elems(tc, src, 0, "native-array-copy");
+    if (d.slot_type != s.slot_type)
+        MVM_exception_throw_adhoc(tc,
+            "native-array-copy requires arrays with the same element type");
+    switch (d.slot_type) {
+        case MVM_ARRAY_OBJ:
+        case MVM_ARRAY_STR:
+        case MVM_ARRAY_U4:
+        case MVM_ARRAY_U2:
+        case MVM_ARRAY_U1:
+        case MVM_ARRAY_I4:
+        case MVM_ARRAY_I2:
+        case MVM_ARRAY_I1:
+            MVM_exception_throw_adhoc(tc,
+                "native-array-copy requires arrays of 8, 16, 32 or 64 bit elements");
+    }
+    if (count < 0 || dest_offset < 0 || src_offset < 0
+            || dest_offset > d.count - count || src_offset > s.count - count)
+        MVM_exception_throw_adhoc(tc,
+            "native-array-copy range out of bounds (copying %"PRId64" elements from %"PRId64" of %"PRId64" to %"PRId64" of %"PRId64")",
+            count, src_offset, s.count, dest_offset, d.count);
+    memmove((char *)d.elems + dest_offset * d.elem_size,
+        (char *)s.elems + src_offset * s.elem_size, count * d.elem_size);
+}
+
+/* Adds the value to or multiplies it into every element of an int64 array. */
+void MVM_nativearray_apply_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 op, MVMint64 value) {
+    NativeElems e = get_elems(tc, arr, 1, "native-array-apply-i");
+    MVMuint64 *elems;
+    MVMint64 i;
+    check_slot_type(tc, &e, MVM_ARRAY_I64, "native-array-apply-i");
+    elems = (MVMuint64 *)e.elems;
+    switch (op) {
+        case MVM_NATIVEARRAY_ADD:
+            for (i = 0; i < e.count; i++)
+                elems[i] += (MVMuint64)value;
+            break;
+        case MVM_NATIVEARRAY_MUL:
+            for (i = 0; i < e.count; i++)
+                elems[i] *= (MVMuint64)value;
+            break;
+        default:
+            MVM_exception_throw_adhoc(tc, "Unknown native array operation %"PRId64, op);
+    }
+}
+
+/* Adds the value to or multiplies it into every element of a num64 array. */
+void MVM_nativearray_apply_n(MVMThreadContext *tc, MVMObject *arr, MVMint64 op, MVMnum64 value) {
+    NativeElems e = get_elems(tc, arr, 1, "native-array-apply-n");
+    MVMnum64 *elems;
+    MVMint64 i;
+    check_slot_type(tc, &e, MVM_ARRAY_N64, "native-array-apply-n");
+    elems = (MVMnum64 *)e.elems;
+    switch (op) {
+        case MVM_NATIVEARRAY_ADD:
+            for (i = 0; i < e.count; i++)
+                elems[i] += value;
+            break;
+        case MVM_NATIVEARRAY_MUL:
+            for (i = 0; i < e.count; i++)
+                elems[i] *= value;
+            break;
+        default:
+            MVM_exception_throw_adhoc(tc, "Unknown native array operation %"PRId64, op);
+    }
+}
+
+/* Adds or multiplies the elements of one array into the corresponding ones
+ * of another of the same size; both must be int64 or both num64. */
+void MVM_nativearray_apply_array(MVMThreadContext *tc, MVMObject *dest, MVMint64 op, MVMObject *src) {
+    NativeElems d = get_elems(tc, dest, 1, "native-array-apply-array");
+    NativeElems s = get_elems(tc, src, 0, "native-array-apply-array");
+    MVMint64 i;
+    if (d.count != s.count)
+        MVM_exception_throw_adhoc(tc,
+            "native-array-apply-array requires arrays of the same size (got %"PRId64" and %"PRId64")",
+            d.count, s.count);
+    if (op != MVM_NATIVEARRAY_ADD && op != MVM_NATIVEARRAY_MUL)
+        MVM_exception_throw_adhoc(tc, "Unknown native array operation %"PRId64, op);
+    if (d.slot_type == MVM_ARRAY_I64 && s.slot_type == MVM_ARRAY_I64) {
+        MVMuint64 *delems = (MVMuint64 *)d.elems;
+        MVMuint64 *selems = (MVMuint64 *)s.elems;
+        if (op == MVM_NATIVEARRAY_ADD)
+            for (i = 0; i < d.count; i++)
+                delems[i] += selems[i];
+        else
+            for (i = 0; i < d.count; i++)
+                delems[i] *= selems[i];
+    }
+    else if (d.slot_type == MVM_ARRAY_N64 && s.slot_type == MVM_ARRAY_N64) {
+        MVMnum64 *delems = (MVMnum64 *)d.elems;
+        MVMnum64 *selems = (MVMnum64 *)s.elems;
+        if (op == MVM_NATIVEARRAY_ADD)
+            for (i = 0; i < d.count; i++)
+                delems[i] += selems[i];
+        else
+            for (i = 0; i < d.count; i++)
+                delems[i] *= selems[i];
+    }
+    else {
+        MVM_exception_throw_adhoc(tc,
+            "native-array-apply-array requires two int64 or two num64 arrays");
+    }
+}
+
+/* Adds each element of one num64 array, multiplied by scale, to the
+ * corresponding element of another of the same size. */
+void MVM_nativearray_fma(MVMThreadContext *tc, MVMObject *dest, MVMObject *src, MVMnum64 scale) {
+    NativeElems d = get_elems(tc, dest, 1, "native-array-fma");
+    NativeElems s = get_elems(tc, src, 0, "native-array-fma");
+    MVMnum64 *delems, *selems;
+    MVMint64 i;
+    check_slot_type(tc, &d, MVM_ARRAY_N64, "native-array-fma");
+    check_slot_type(tc, &s, MVM_ARRAY_N64, "native-array-fma");
+    if (d.count != s.count)
+        MVM_exception_throw_adhoc(tc,
+            "native-array-fma requires arrays of the same size (got %"PRId64" and %"PRId64")",
+            d.count, s.count);
+    delems = (MVMnum64 *)d.elems;
+    selems = (MVMnum64 *)s.elems;
+    for (i = 0; i < d.count; i++)
+        delems[i] += selems[i] * scale;
+}
+
+/* Reduces an int64 array to its sum, minimum or maximum. The sum of an empty
+ * array is zero; it has no minimum or maximum. */
+MVMint64 MVM_nativearray_reduce_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 op) {
+    NativeElems e = get_elems(tc, arr, 0, "native-array-reduce-i");
+    MVMint64 *elems;
+    MVMint64 i, result;
+    check_slot_type(tc, &e, MVM_ARRAY_I64, "native-array-reduce-i");
+    elems = (MVMint64 *)e.elems;
+    if (op == MVM_NATIVEARRAY_SUM) {
+        MVMuint64 sum = 0;
+        for (i = 0; i < e.count; i++)
+            sum += (MVMuint64)elems[i];
+        return (MVMint64)sum;
+    }
+    if (op != MVM_NATIVEARRAY_MIN && op != MVM_NATIVEARRAY_MAX)
+        MVM_exception_throw_adhoc(tc, "Unknown native array reduction %"PRId64, op);
+    if (e.count == 0)
+        MVM_exception_throw_adhoc(tc, "Cannot take the %s of an empty array",
+            op == MVM_NATIVEARRAY_MIN ? "minimum" : "maximum");
+    result = elems[0];
+    if (op == MVM_NATIVEARRAY_MIN)
+        for (i = 1; i < e.count; i++)
+            result = elems[i] < result ? elems[i] : result;
+    else
+        for (i = 1; i < e.count; i++)
+            result = elems[i] > result ? elems[i] : result;
+    return result;
+}
+
+/* Reduces a num64 array to its sum, minimum or maximum. */
+MVMnum64 MVM_nativearray_reduce_n(MVMThreadContext *tc, MVMObject *arr, MVMint64 op) {
+    NativeElems e = get_elems(tc, arr, 0, "native-array-reduce-n");
+    MVMnum64 *elems;
+    MVMnum64 result;
+    MVMint64 i;
+    check_slot_type(tc, &e, MVM_ARRAY_N64, "native-array-reduce-n");
+    elems = (MVMnum64 *)e.elems;
+    if (op == MVM_NATIVEARRAY_SUM) {
+        result = 0.0;
+        for (i = 0; i < e.count; i++)
+            result += elems[i];
+        return result;
+    }
+    if (op != MVM_NATIVEARRAY_MIN && op != MVM_NATIVEARRAY_MAX)
+        MVM_exception_throw_adhoc(tc, "Unknown native array reduction %"PRId64, op);
+    if (e.count == 0)
+        MVM_exception_throw_adhoc(tc, "Cannot take the %s of an empty array",
+            op == MVM_NATIVEARRAY_MIN ? "minimum" : "maximum");
+    result = elems[0];
+    if (op == MVM_NATIVEARRAY_MIN)
+        for (i = 1; i < e.count; i++)
+            result = elems[i] < result ? elems[i] : result;
+    else
+        for (i = 1; i < e.count; i++)
+            result = elems[i] > result ? elems[i] : result;
+    return result;
+}
+
+/* Resizes a mask array, which must be a VMArray of 8 bit integers, to the
+ * number of elements being compared and gets at its elements. */
+static MVMuint8 * prepare_mask(MVMThreadContext *tc, MVMObject *mask, MVMint64 count,
+        const char *what) {
+    MVMArrayREPRData *repr_data;
+    if (!IS_CONCRETE(mask) || REPR(mask)->ID != MVM_REPR_ID_VMArray)
+        MVM_exception_throw_adhoc(tc, "%s requires a concrete VMArray for the mask", what);
+    repr_data = (MVMArrayREPRData *)STABLE(mask)->REPR_data;
+    if (repr_data->slot_type != MVM_ARRAY_I8 && repr_data->slot_type != MVM_ARRAY_U8)
+        MVM_exception_throw_adhoc(tc, "%s requires a mask array of 8 bit integers", what);
+    MVM_repr_pos_set_elems(tc, mask, count);
+    return (MVMuint8 *)MVM_VMArray_bulk_elems(tc, mask, 1);
+}
+
+#define COMPARE_LOOP(cmp) \
+    for (i = 0; i < e.count; i++) \
+        out[i] = elems[i] cmp value;
+
+/* Sets each element of the mask to 1 if the corresponding element of an int64
+ * array compares to the value as asked, and 0 otherwise. */
+void MVM_nativearray_compare_i(MVMThreadContext *tc, MVMObject *mask, MVMObject *arr,
+        MVMint64 op, MVMint64 value) {
+    NativeElems e = get_elems(tc, arr, 0, "native-array-compare-i");
+    MVMint64 *elems;
+    MVMuint8 *out;
+    MVMint64 i;
+    check_slot_type(tc, &e, MVM_ARRAY_I64, "native-array-compare-i");
+    out   = prepare_mask(tc, mask, e.count, "native-array-compare-i");
+    elems = (MVMint64 *)e.elems;
+    switch (op) {
+        case MVM_NATIVEARRAY_EQ: COMPARE_LOOP(==); break;
+        case MVM_NATIVEARRAY_NE: COMPARE_LOOP(!=); break;
+        case MVM_NATIVEARRAY_LT: COMPARE_LOOP(<);  break;
+        case MVM_NATIVEARRAY_LE: COMPARE_LOOP(<=); break;
+        case MVM_NATIVEARRAY_GT: COMPARE_LOOP(>);  break;
+        case MVM_NATIVEARRAY_GE: COMPARE_LOOP(>=); break;
+        default:
+            MVM_exception_throw_adhoc(tc, "Unknown native array comparison %"PRId64, op);
+    }
+}
+
+/* Sets each element of the mask to 1 if the corresponding element of a num64
+ * array compares to the value as asked, and 0 otherwise. */
+void MVM_nativearray_compare_n(MVMThreadContext *tc, MVMObject *mask, MVMObject *arr,
+        MVMint64 op, MVMnum64 value) {
+    NativeElems e = get_elems(tc, arr, 0, "native-array-compare-n");
+    MVMnum64 *elems;
+    MVMuint8 *out;
+    MVMint64 i;
+    check_slot_type(tc, &e, MVM_ARRAY_N64, "native-array-compare-n");
+    out   = prepare_mask(tc, mask, e.count, "native-array-compare-n");
+    elems = (MVMnum64 *)e.elems;
+    switch (op) {
+        case MVM_NATIVEARRAY_EQ: COMPARE_LOOP(==); break;
+        case MVM_NATIVEARRAY_NE: COMPARE_LOOP(!=); break;
+        case MVM_NATIVEARRAY_LT: COMPARE_LOOP(<);  break;
+        case MVM_NATIVEARRAY_LE: COMPARE_LOOP(<=); break;
+        case MVM_NATIVEARRAY_GT: COMPARE_LOOP(>);  break;
+        case MVM_NATIVEARRAY_GE: COMPARE_LOOP(>=); break;
+        default:
+            MVM_exception_throw_adhoc(tc, "Unknown native array comparison %"PRId64, op);
+    }
+}
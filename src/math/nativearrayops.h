@@ -0,0 +1,31 @@
+/* Element-wise operations applied to whole native arrays. */
+#define MVM_NATIVEARRAY_ADD     0
+#define MVM_NATIVEARRAY_MUL     1
+
+/* Reductions of a whole native array to a single value. */
+#define MVM_NATIVEARRAY_SUM     0
+#define MVM_NATIVEARRAY_MIN     1
+#define MVM_NATIVEARRAY_MAX     2
+
+/* Comparisons of each element of a native array against a value. */
+#define MVM_NATIVEARRAY_EQ      0
+#define MVM_NATIVEARRAY_NE      1
+#define MVM_NATIVEARRAY_LT      2
+#define MVM_NATIVEARRAY_LE      3
+#define MVM_NATIVEARRAY_GT      4
+#define MVM_NATIVEARRAY_GE      5
+
+void MVM_nativearray_fill_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 value);
+void MVM_nativearray_fill_n(MVMThreadContext *tc, MVMObject *arr, MVMnum64 value);
+void MVM_nativearray_copy(MVMThreadContext *tc, MVMObject *dest, MVMint64 dest_offset,
+    MVMObject *src, MVMint64 src_offset, MVMint64 count);
+void MVM_nativearray_apply_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 op, MVMint64 value);
+void MVM_nativearray_apply_n(MVMThreadContext *tc, MVMObject *arr, MVMint64 op, MVMnum64 value);
+void MVM_nativearray_apply_array(MVMThreadContext *tc, MVMObject *dest, MVMint64 op, MVMObject *src);
+void MVM_nativearray_fma(MVMThreadContext *tc, MVMObject *dest, MVMObject *src, MVMnum64 scale);
+MVMint64 MVM_nativearray_reduce_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 op);
+MVMnum64 MVM_nativearray_reduce_n(MVMThreadContext *tc, MVMObject *arr, MVMint64 op);
+void MVM_nativearray_compare_i(MVMThreadContext *tc, MVMObject *mask, MVMObject *arr,
+    MVMint64 op, MVMint64 value);
+void MVM_nativearray_compare_n(MVMThreadContext *tc, MVMObject *mask, MVMObject *arr,
+    MVMint64 op, MVMnum64 value);
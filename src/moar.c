@@ -108,6 +108,7 @@ MVMInstance * MVM_vm_create_instance(void) {
          *spesh_pea_disable;
     char *jit_expr_enable, *jit_disable, *jit_last_frame, *jit_last_bb;
     char *dynvar_log;
+    char *event_loops, *timer_granularity;
     int init_stat;
 
 #ifndef MVM_THREAD_LOCAL
@@ -202,6 +203,10 @@ MVMInstance * MVM_vm_create_instance(void) {
     init_mutex(instance->mutex_sc_registry, "sc registry");
     MVM_str_hash_build(instance->main_thread, &instance->sc_weakhash, sizeof(struct MVMSerializationContextWeakHashEntry), 0);
 
+    /* Set up interned strings table and its mutex. */
+    init_mutex(instance->mutex_interned_strings, "interned strings");
+    MVM_str_hash_build(instance->main_thread, &instance->interned_strings, sizeof(struct MVMStrHashHandle), 0);
+
     /* Set up loaded compunits hash mutex. */
     init_mutex(instance->mutex_loaded_compunits, "loaded compunits");
     MVM_fixkey_hash_build(instance->main_thread, &instance->loaded_compunits, sizeof(MVMString *));
@@ -239,8 +244,18 @@ MVMInstance * MVM_vm_create_instance(void) {
     /* Set up main thread's last_payload. */
     instance->main_thread->last_payload = instance->VMNull;
 
-    /* Initialize event loop thread starting mutex. */
+    /* Initialize event loop thread starting mutex, and decide how many event
+     * loops to run. */
     init_mutex(instance->mutex_event_loop, "event loop thread start");
+    event_loops = getenv("MVM_EVENT_LOOPS");
+    instance->num_event_loops = event_loops && atoi(event_loops) > 0
+        ? atoi(event_loops) : 1;
+    if (instance->num_event_loops > MVM_EVENT_LOOPS_MAX)
+        instance->num_event_loops = MVM_EVENT_LOOPS_MAX;
+    instance->event_loops = MVM_calloc(instance->num_event_loops, sizeof(MVMEventLoop));
+    timer_granularity = getenv("MVM_TIMER_GRANULARITY");
+    instance->timer_granularity = timer_granularity && atoi(timer_granularity) > 0
+        ? atoi(timer_granularity) : 1;
 
     /* Create main thread object, and also make it the start of the all threads
      * linked list. Set up the mutex to protect it. */
@@ -721,6 +736,10 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     uv_mutex_destroy(&instance->mutex_sc_registry);
     MVM_str_hash_demolish(instance->main_thread, &instance->sc_weakhash);
 
+    /* Clean up interned strings table. */
+    uv_mutex_destroy(&instance->mutex_interned_strings);
+    MVM_str_hash_demolish(instance->main_thread, &instance->interned_strings);
+
     /* Clean up Hash of filenames of compunits loaded from disk. */
     uv_mutex_destroy(&instance->mutex_loaded_compunits);
     MVM_fixkey_hash_demolish(instance->main_thread, &instance->loaded_compunits);
@@ -782,8 +801,9 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     MVM_free(instance->int_const_cache);
     MVM_free(instance->int_to_str_cache);
 
-    /* Clean up event loop mutex. */
+    /* Clean up event loop mutex and pool. */
     uv_mutex_destroy(&instance->mutex_event_loop);
+    MVM_free(instance->event_loops);
 
     /* Clean up safepoint free list. */
     uv_mutex_destroy(&instance->mutex_free_at_safepoint);
@@ -286,7 +286,9 @@ MVM_PUBLIC MVMint32 MVM_jit_support(void);
 #include "io/signals.h"
 #include "io/asyncsocket.h"
 #include "io/asyncsocketudp.h"
+#include "io/asyncfile.h"
 #include "math/bigintops.h"
+#include "math/nativearrayops.h"
 #include "core/intcache.h"
 #include "jit/graph.h"
 #include "jit/label.h"
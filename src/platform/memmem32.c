@@ -39,12 +39,27 @@
  * The only caveats is the table uses a modulus so it can only jump to the next
  * codepoint of the same modulus. */
 
+/* Number of haystack positions tested per block by the filtering loops below.
+ * The loops testing a block have no early exit, so the compiler is able to
+ * vectorize them; only blocks with at least one candidate are looked at more
+ * closely. */
+#define FILTER_BLOCK 32
+
 /* For memmem_one32 we just look for a single 32 bit integer in the haystack,
  * simple. */
 static uint32_t * memmem_one_uint32(const uint32_t *h0, const uint32_t *n0, const uint32_t *end_h0) {
 	uint32_t *h           = (uint32_t*)h0;
 	const uint32_t  n     = *n0;
 	const uint32_t *end_h = end_h0 - 1;
+	while (h + FILTER_BLOCK <= end_h0) {
+		uint32_t found = 0;
+		size_t k;
+		MVM_VECTORIZE_LOOP
+		for (k = 0; k < FILTER_BLOCK; k++)
+			found |= h[k] == n;
+		if (found) break;
+		h += FILTER_BLOCK;
+	}
 	for (; h <= end_h; h++) {
 		if (*h == n) return h;
 	}
@@ -184,6 +199,112 @@ static char *twoway_memmem_uint32(const uint32_t *h, const uint32_t *z, const ui
 		mem = mem0;
 	}
 }
+/* The mixed width searches use the first and last grapheme of the needle as a
+ * filter: a block of haystack positions is checked for both at once, and only
+ * the positions where both match are compared in full. Worst case this is
+ * O(H_len * n_len), so callers should only use it for short needles and widen
+ * or narrow longer ones to use the two-way search instead. */
+static int equal_int32_int8(const int32_t *h, const int8_t *n, size_t l) {
+	size_t i;
+	for (i = 0; i < l; i++)
+		if (h[i] != n[i]) return 0;
+	return 1;
+}
+static int equal_int8_int32(const int8_t *h, const int32_t *n, size_t l) {
+	size_t i;
+	for (i = 0; i < l; i++)
+		if (h[i] != n[i]) return 0;
+	return 1;
+}
+
+/* Finds a needle of signed 8 bit graphemes in a haystack of 32 bit graphemes.
+ * H_len and n_len are measured in elements. */
+void * memmem_uint32_uint8(const void *h0, size_t H_len, const void *n0, size_t n_len)
+{
+	const int32_t *h = (int32_t*)h0;
+	const int8_t  *n = (int8_t*)n0;
+	int32_t first, last;
+	size_t i = 0, k, last_pos, middle_len, positions;
+
+	if (!n_len) return (void *)h;
+	if (H_len < n_len)
+		return NULL;
+
+	first      = n[0];
+	last       = n[n_len - 1];
+	last_pos   = n_len - 1;
+	middle_len = n_len > 2 ? n_len - 2 : 0;
+	positions  = H_len - n_len + 1;
+
+	while (i + FILTER_BLOCK <= positions) {
+		uint8_t  hits[FILTER_BLOCK];
+		uint32_t found = 0;
+		MVM_VECTORIZE_LOOP
+		for (k = 0; k < FILTER_BLOCK; k++) {
+			hits[k] = (h[i + k] == first) & (h[i + k + last_pos] == last);
+			found  |= hits[k];
+		}
+		if (found) {
+			for (k = 0; k < FILTER_BLOCK; k++)
+				if (hits[k] && equal_int32_int8(h + i + k + 1, n + 1, middle_len))
+					return (void *)(h + i + k);
+		}
+		i += FILTER_BLOCK;
+	}
+	for (; i < positions; i++) {
+		if (h[i] == first && h[i + last_pos] == last
+		 && equal_int32_int8(h + i + 1, n + 1, middle_len))
+			return (void *)(h + i);
+	}
+	return NULL;
+}
+
+/* Finds a needle of 32 bit graphemes in a haystack of signed 8 bit graphemes.
+ * A needle containing anything that doesn't fit into 8 bits can't match.
+ * H_len and n_len are measured in elements. */
+void * memmem_uint8_uint32(const void *h0, size_t H_len, const void *n0, size_t n_len)
+{
+	const int8_t  *h = (int8_t*)h0;
+	const int32_t *n = (int32_t*)n0;
+	int8_t first, last;
+	size_t i = 0, k, last_pos, middle_len, positions;
+
+	if (!n_len) return (void *)h;
+	if (H_len < n_len)
+		return NULL;
+	for (k = 0; k < n_len; k++)
+		if (n[k] < -128 || 127 < n[k])
+			return NULL;
+
+	first      = (int8_t)n[0];
+	last       = (int8_t)n[n_len - 1];
+	last_pos   = n_len - 1;
+	middle_len = n_len > 2 ? n_len - 2 : 0;
+	positions  = H_len - n_len + 1;
+
+	while (i + FILTER_BLOCK <= positions) {
+		uint8_t  hits[FILTER_BLOCK];
+		uint32_t found = 0;
+		MVM_VECTORIZE_LOOP
+		for (k = 0; k < FILTER_BLOCK; k++) {
+			hits[k] = (h[i + k] == first) & (h[i + k + last_pos] == last);
+			found  |= hits[k];
+		}
+		if (found) {
+			for (k = 0; k < FILTER_BLOCK; k++)
+				if (hits[k] && equal_int8_int32(h + i + k + 1, n + 1, middle_len))
+					return (void *)(h + i + k);
+		}
+		i += FILTER_BLOCK;
+	}
+	for (; i < positions; i++) {
+		if (h[i] == first && h[i + last_pos] == last
+		 && equal_int8_int32(h + i + 1, n + 1, middle_len))
+			return (void *)(h + i);
+	}
+	return NULL;
+}
+
 /* Finds the memory location of the needle in the haystack. Arguments are the
  * memory location of the start of the Haystack, the memory location of the start
  * of the needle and the needle length as well as the Haystack length.
@@ -1 +1,3 @@
 void *memmem_uint32(const void *h0, size_t k, const void *n0, size_t l);
+void *memmem_uint32_uint8(const void *h0, size_t H_len, const void *n0, size_t n_len);
+void *memmem_uint8_uint32(const void *h0, size_t H_len, const void *n0, size_t n_len);
@@ -420,9 +420,82 @@ static MVMint32 find_separator(MVMThreadContext *tc, const MVMDecodeStream *ds,
     }
     return 0;
 }
+
+/* Fast path for reading a line of ASCII text, which is common enough to be
+ * worth not decoding to graphemes and searching those for the separators.
+ * When nothing is left decoded or in the normalizer, the encoding leaves
+ * ASCII unchanged, and the separators permit it, we look for the final byte
+ * of the separators in the undecoded bytes, and if what comes before it is
+ * all ASCII, that's the line, and we make an 8-bit string of it directly.
+ * A lone \r would become part of a \r\n grapheme, so lines with any \r other
+ * than one ending a \r\n separator that we're chomping are left to the full
+ * path, as are lines that span byte buffers. Returns NULL if not applicable. */
+static MVMString * get_ascii_line(MVMThreadContext *tc, MVMDecodeStream *ds,
+                                  MVMDecodeStreamSeparators *sep_spec, MVMint32 chomp) {
+    MVMDecodeStreamBytes *bytes = ds->bytes_head;
+    MVMuint8  *start, *end, *cr;
+    MVMint32   line_length, result_length, i;
+    MVMuint8   high_bits = 0;
+    MVMString *result;
+
+    if (sep_spec->final_byte < 0 || !bytes || ds->chars_head
+            || !MVM_unicode_normalizer_empty(tc, &(ds->norm)))
+        return NULL;
+    if (ds->encoding != MVM_encoding_type_utf8 && ds->encoding != MVM_encoding_type_ascii
+            && ds->encoding != MVM_encoding_type_latin1)
+        return NULL;
+
+    /* Find the end of the line. */
+    start = bytes->bytes + ds->bytes_head_pos;
+    end   = memchr(start, sep_spec->final_byte, bytes->length - ds->bytes_head_pos);
+    if (!end)
+        return NULL;
+    line_length = end - start;
+
+    /* Check it's all ASCII. */
+    MVM_VECTORIZE_LOOP
+    for (i = 0; i < line_length; i++)
+        high_bits |= start[i];
+    if (high_bits & 0x80)
+        return NULL;
+
+    /* Work out which separator ended it, and how much of it to return. */
+    cr = line_length > 0 ? memchr(start, '\r', line_length) : NULL;
+    if (cr) {
+        if (cr != end - 1 || !sep_spec->crlf_is_sep || !chomp
+                || ds->norm.translate_newlines)
+            return NULL;
+        result_length = line_length - 1;
+    }
+    else {
+        if (!sep_spec->final_byte_is_sep)
+            return NULL;
+        result_length = chomp ? line_length : line_length + 1;
+    }
+
+    /* Make the string and consume the line. */
+    if (result_length > 0) {
+        result = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
+        result->body.storage_type    = MVM_STRING_GRAPHEME_8;
+        result->body.storage.blob_8  = MVM_malloc(result_length);
+        result->body.num_graphs      = result_length;
+        memcpy(result->body.storage.blob_8, start, result_length);
+    }
+    else {
+        result = tc->instance->str_consts.empty;
+    }
+    MVM_string_decodestream_discard_to(tc, ds, bytes, ds->bytes_head_pos + line_length + 1);
+    return result;
+}
+
 MVMString * MVM_string_decodestream_get_until_sep(MVMThreadContext *tc, MVMDecodeStream *ds,
                                                   MVMDecodeStreamSeparators *sep_spec, MVMint32 chomp) {
     MVMint32 sep_loc, sep_length;
+    MVMString *line;
+
+    /* Try the fast path for ASCII text first. */
+    if ((line = get_ascii_line(tc, ds, sep_spec, chomp)))
+        return line;
 
     /* Look for separator, trying more decoding if it fails. We get the place
      * just beyond the separator, so can use take_chars to get what's need.
@@ -674,6 +747,28 @@ static void cache_sep_info(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_
     sep_spec->max_sep_length = max_sep_length;
     sep_spec->final_graphemes = final_graphemes;
     sep_spec->max_final_grapheme = max_final_grapheme;
+
+    /* See if lines can be found by scanning bytes for a single final byte. */
+    sep_spec->final_byte = -1;
+    sep_spec->final_byte_is_sep = 0;
+    sep_spec->crlf_is_sep = 0;
+    if (max_sep_length == 1) {
+        MVMGrapheme32 crlf = MVM_nfg_crlf_grapheme(tc);
+        MVMint32 final_byte = -1;
+        for (i = 0; i < sep_spec->num_seps; i++) {
+            MVMGrapheme32 g = final_graphemes[i];
+            MVMint32 byte = g == crlf ? '\n' : g;
+            if (byte < 0 || byte >= 0x80 || byte == '\r'
+                    || (final_byte >= 0 && byte != final_byte))
+                return;
+            final_byte = byte;
+            if (g == crlf)
+                sep_spec->crlf_is_sep = 1;
+            else
+                sep_spec->final_byte_is_sep = 1;
+        }
+        sep_spec->final_byte = final_byte;
+    }
 }
 
 /* Sets a decode stream separator to its default value. */
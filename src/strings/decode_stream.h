@@ -86,6 +86,15 @@ struct MVMDecodeStreamSeparators {
      * maximum codepoint/synthetic index of any final grapheme and doing a
      * quick comparison. */
     MVMGrapheme32 max_final_grapheme;
+
+    /* If every separator is a single ASCII grapheme (counting \r\n as one)
+     * and they all end in the same byte, that byte, so that lines of ASCII
+     * text can be found by scanning the undecoded bytes; -1 otherwise. Along
+     * with it, whether \r\n is one of the separators, and whether the final
+     * byte on its own is. */
+    MVMint32 final_byte;
+    MVMuint8 final_byte_is_sep;
+    MVMuint8 crlf_is_sep;
 };
 
 /* Checks if we may have encountered one of the separators. This just looks to
@@ -39,7 +39,7 @@ void MVM_unicode_normalize_codepoints(MVMThreadContext *tc, const MVMObject *in,
     MVMNormalizer  norm;
     MVMCodepoint  *input;
     MVMCodepoint  *result;
-    MVMint64       input_pos, input_codes, result_pos, result_alloc;
+    MVMint64       input_codes, result_pos, result_alloc;
     MVMint32       ready;
 
     /* Validate input/output array. */
@@ -58,19 +58,9 @@ void MVM_unicode_normalize_codepoints(MVMThreadContext *tc, const MVMObject *in,
 
     /* Perform normalization. */
     MVM_unicode_normalizer_init(tc, &norm, form);
-    input_pos  = 0;
     result_pos = 0;
-    while (input_pos < input_codes) {
-        MVMCodepoint cp;
-        ready = MVM_unicode_normalizer_process_codepoint(tc, &norm, input[input_pos], &cp);
-        if (ready) {
-            maybe_grow_result(&result, &result_alloc, result_pos + ready);
-            result[result_pos++] = cp;
-            while (--ready > 0)
-                result[result_pos++] = MVM_unicode_normalizer_get_codepoint(tc, &norm);
-        }
-        input_pos++;
-    }
+    MVM_unicode_normalizer_process_codepoints(tc, &norm, input, input_codes,
+        &result, &result_pos, &result_alloc);
     MVM_unicode_normalizer_eof(tc, &norm);
     ready = MVM_unicode_normalizer_available(tc, &norm);
     maybe_grow_result(&result, &result_alloc, result_pos + ready);
@@ -80,8 +70,7 @@ void MVM_unicode_normalize_codepoints(MVMThreadContext *tc, const MVMObject *in,
 
     MVMArrayBody *out_body = &((MVMArray *)out)->body;
     /* Free previous slots array if it exists. */
-    if (out_body->slots.any)
-        MVM_free(out_body->slots.any);
+    MVM_VMArray_free_storage(tc, out_body);
 
     /* Put result into array body. */
     out_body->slots.u32 = (MVMuint32 *)result;
@@ -92,7 +81,7 @@ void MVM_unicode_normalize_codepoints(MVMThreadContext *tc, const MVMObject *in,
 }
 MVMString * MVM_unicode_codepoints_c_array_to_nfg_string(MVMThreadContext *tc, MVMCodepoint * cp_v, MVMint64 cp_count) {
     MVMNormalizer  norm;
-    MVMint64       input_pos, result_pos, result_alloc;
+    MVMint64       result_pos, result_alloc;
     MVMGrapheme32 *result;
     MVMint32       ready;
     MVMString     *str;
@@ -106,19 +95,9 @@ MVMString * MVM_unicode_codepoints_c_array_to_nfg_string(MVMThreadContext *tc, M
 
     /* Perform normalization at grapheme level. */
     MVM_unicode_normalizer_init(tc, &norm, MVM_NORMALIZE_NFG);
-    input_pos  = 0;
     result_pos = 0;
-    while (input_pos < cp_count) {
-        MVMGrapheme32 g;
-        ready = MVM_unicode_normalizer_process_codepoint_to_grapheme(tc, &norm, cp_v[input_pos], &g);
-        if (ready) {
-            maybe_grow_result(&result, &result_alloc, result_pos + ready);
-            result[result_pos++] = g;
-            while (--ready > 0)
-                result[result_pos++] = MVM_unicode_normalizer_get_grapheme(tc, &norm);
-        }
-        input_pos++;
-    }
+    MVM_unicode_normalizer_process_codepoints(tc, &norm, cp_v, cp_count,
+        &result, &result_pos, &result_alloc);
     MVM_unicode_normalizer_eof(tc, &norm);
     ready = MVM_unicode_normalizer_available(tc, &norm);
     maybe_grow_result(&result, &result_alloc, result_pos + ready);
@@ -196,7 +175,8 @@ void MVM_unicode_string_to_codepoints(MVMThreadContext *tc, MVMString *s, MVMNor
         MVM_unicode_normalizer_cleanup(tc, &norm);
     }
 
-    /* Put result into array body. */
+    /* Put result into array body, freeing any previous slots. */
+    MVM_VMArray_free_storage(tc, &((MVMArray *)out)->body);
     ((MVMArray *)out)->body.slots.u32 = (MVMuint32 *)result;
     ((MVMArray *)out)->body.start     = 0;
     ((MVMArray *)out)->body.elems     = result_pos;
@@ -400,6 +380,52 @@ MVMint32 MVM_string_is_control_full(MVMThreadContext *tc, MVMCodepoint in) {
     return 0;
 }
 
+/* Codepoints that the normalizer can pass straight through: they are not
+ * normalization terminators, pass the quick check for the form, have a CCC
+ * of zero, and are neither Prepend nor control characters. Seeing two of them
+ * in a row means the first can be handed back as it is, which covers most
+ * input, so we want to know this without a pile of property lookups. We keep
+ * a bitmap of them over the BMP for each form, filled in lazily a block of
+ * 256 codepoints at a time. Threads racing to fill in a block compute the
+ * same bits, so all that matters is the bits are stored before the block is
+ * flagged as ready. */
+#define PASS_THROUGH_FORMS      5
+#define PASS_THROUGH_BLOCK_BITS 8
+#define PASS_THROUGH_BLOCK_SIZE (1 << PASS_THROUGH_BLOCK_BITS)
+static MVMuint8 pass_through_bits[PASS_THROUGH_FORMS][0x10000 / 8];
+static AO_t     pass_through_ready[PASS_THROUGH_FORMS][0x10000 / PASS_THROUGH_BLOCK_SIZE];
+
+static int is_pass_through_full(MVMThreadContext *tc, const MVMNormalizer *n, MVMCodepoint cp) {
+    if (cp < 0x20 || (0x7F <= cp && cp <= 0x9F) || cp == 0xAD)
+        return 0;
+    return passes_quickcheck(tc, n, cp)
+        && MVM_unicode_relative_ccc(tc, cp) == 0
+        && MVM_unicode_codepoint_get_property_int(tc, cp,
+            MVM_UNICODE_PROPERTY_GRAPHEME_CLUSTER_BREAK) != MVM_UNICODE_PVALUE_GCB_PREPEND
+        && (cp <= 0xFF || !MVM_string_is_control_full(tc, cp));
+}
+static void compute_pass_through_block(MVMThreadContext *tc, const MVMNormalizer *n, MVMint32 form, MVMint32 block) {
+    MVMuint8 bits[PASS_THROUGH_BLOCK_SIZE / 8] = { 0 };
+    MVMCodepoint first = block << PASS_THROUGH_BLOCK_BITS;
+    MVMint32 i;
+    for (i = 0; i < PASS_THROUGH_BLOCK_SIZE; i++)
+        if (is_pass_through_full(tc, n, first + i))
+            bits[i >> 3] |= 1 << (i & 7);
+    memcpy(&pass_through_bits[form][first >> 3], bits, sizeof(bits));
+    MVM_store(&pass_through_ready[form][block], 1);
+}
+MVM_STATIC_INLINE int is_pass_through(MVMThreadContext *tc, const MVMNormalizer *n, MVMCodepoint cp) {
+    MVMint32 form, block;
+    /* Synthetics and codepoints beyond the BMP just take the full path. */
+    if (cp < 0 || cp > 0xFFFF)
+        return 0;
+    form  = n->form == MVM_NORMALIZE_NFG ? PASS_THROUGH_FORMS - 1 : n->form;
+    block = cp >> PASS_THROUGH_BLOCK_BITS;
+    if (MVM_UNLIKELY(!MVM_load(&pass_through_ready[form][block])))
+        compute_pass_through_block(tc, n, form, block);
+    return (pass_through_bits[form][cp >> 3] >> (cp & 7)) & 1;
+}
+
 /* Implements the Unicode Canonical Ordering algorithm (3.11, D109). */
 static void canonical_sort(MVMThreadContext *tc, MVMNormalizer *n, MVMint32 from, MVMint32 to) {
     /* Yes, this is the simplest possible thing. Key thing if you decide to
@@ -964,7 +990,26 @@ static void grapheme_composition(MVMThreadContext *tc, MVMNormalizer *n, MVMint3
  * compute the normalization. */
 MVMint32 MVM_unicode_normalizer_process_codepoint_full(MVMThreadContext *tc, MVMNormalizer *norm, MVMCodepoint in, MVMCodepoint *out) {
     MVMint64 qc_in, ccc_in;
-    int is_prepend = MVM_unicode_codepoint_get_property_int(
+    int is_prepend;
+
+    /* The fast cases below, for codepoints that pass straight through, but
+     * without doing the property lookups. */
+    if (norm->prepend_buffer == 0 && is_pass_through(tc, norm, in)) {
+        if (MVM_NORMALIZE_COMPOSE(norm->form)) {
+            if (norm->buffer_end - norm->buffer_start == 1
+                    && is_pass_through(tc, norm, norm->buffer[norm->buffer_start])) {
+                *out = norm->buffer[norm->buffer_start];
+                norm->buffer[norm->buffer_start] = in;
+                return 1;
+            }
+        }
+        else if (norm->buffer_start == norm->buffer_end) {
+            *out = in;
+            return 1;
+        }
+    }
+
+    is_prepend = MVM_unicode_codepoint_get_property_int(
         tc, in, MVM_UNICODE_PROPERTY_GRAPHEME_CLUSTER_BREAK) == MVM_UNICODE_PVALUE_GCB_PREPEND;
 
     if (MVM_UNLIKELY(0 < norm->prepend_buffer))
@@ -1064,6 +1109,59 @@ MVMint32 MVM_unicode_normalizer_process_codepoint_full(MVMThreadContext *tc, MVM
     return norm->buffer_norm_end - norm->buffer_start++;
 }
 
+/* Normalizes a run of codepoints, appending whatever becomes available to
+ * *result at *result_pos, growing it as needed. Runs of codepoints that pass
+ * straight through are copied out in bulk; only the codepoints around them go
+ * through the normalizer one at a time. */
+void MVM_unicode_normalizer_process_codepoints(MVMThreadContext *tc, MVMNormalizer *n,
+        const MVMCodepoint *in, MVMint64 num_codepoints,
+        MVMCodepoint **result, MVMint64 *result_pos, MVMint64 *result_alloc) {
+    MVMint32 compose = MVM_NORMALIZE_COMPOSE(n->form);
+    MVMint64 pos     = 0;
+    while (pos < num_codepoints) {
+        MVMCodepoint cp;
+        MVMint32 ready;
+
+        /* If we're in the state where a codepoint that passes through can be
+         * handed back right away, then so can a whole run of them. When
+         * composing, the last one of the run stays in the buffer. */
+        if (n->prepend_buffer == 0 && (compose
+                ? n->buffer_end - n->buffer_start == 1
+                    && n->buffer_norm_end <= n->buffer_start
+                    && is_pass_through(tc, n, n->buffer[n->buffer_start])
+                : n->buffer_start == n->buffer_end)) {
+            MVMint64 run_end = pos;
+            while (run_end < num_codepoints && is_pass_through(tc, n, in[run_end]))
+                run_end++;
+            if (run_end > pos) {
+                MVMint64 run = run_end - pos;
+                maybe_grow_result(result, result_alloc, *result_pos + run);
+                if (compose) {
+                    (*result)[(*result_pos)++] = n->buffer[n->buffer_start];
+                    memcpy(*result + *result_pos, in + pos, (run - 1) * sizeof(MVMCodepoint));
+                    *result_pos += run - 1;
+                    n->buffer[n->buffer_start] = in[run_end - 1];
+                }
+                else {
+                    memcpy(*result + *result_pos, in + pos, run * sizeof(MVMCodepoint));
+                    *result_pos += run;
+                }
+                pos = run_end;
+                continue;
+            }
+        }
+
+        /* Otherwise, take a single step. */
+        ready = MVM_unicode_normalizer_process_codepoint(tc, n, in[pos++], &cp);
+        if (ready) {
+            maybe_grow_result(result, result_alloc, *result_pos + ready);
+            (*result)[(*result_pos)++] = cp;
+            while (--ready > 0)
+                (*result)[(*result_pos)++] = MVM_unicode_normalizer_get_codepoint(tc, n);
+        }
+    }
+}
+
 /* Push a number of codepoints into the "to normalize" buffer. */
 void MVM_unicode_normalizer_push_codepoints(MVMThreadContext *tc, MVMNormalizer *n, const MVMCodepoint *in, MVMint32 num_codepoints) {
     MVMint32 i;
@@ -155,6 +155,12 @@ MVM_STATIC_INLINE MVMint32 MVM_unicode_normalizer_process_codepoint_to_grapheme(
     return MVM_unicode_normalizer_process_codepoint(tc, n, in, (MVMGrapheme32 *)out);
 }
 
+/* Normalize a run of codepoints, appending what becomes available to a
+ * growable result buffer. */
+void MVM_unicode_normalizer_process_codepoints(MVMThreadContext *tc, MVMNormalizer *n,
+        const MVMCodepoint *in, MVMint64 num_codepoints,
+        MVMCodepoint **result, MVMint64 *result_pos, MVMint64 *result_alloc);
+
 /* Push a number of codepoints into the "to normalize" buffer. */
 void MVM_unicode_normalizer_push_codepoints(MVMThreadContext *tc, MVMNormalizer *n, const MVMCodepoint *in, MVMint32 num_codepoints);
 
@@ -161,6 +161,8 @@ void NFG_check_concat (MVMThreadContext *tc, MVMString *result, MVMString *a, MV
 
 MVM_STATIC_INLINE MVMint64 string_equal_at_ignore_case_INTERNAL_loop(MVMThreadContext *tc, void *Hs_or_gic, MVMString *needle_fc, MVMint64 H_start, MVMint64 H_graphs, MVMint64 n_fc_graphs, int ignoremark, int ignorecase, int is_gic);
 static MVMint64 knuth_morris_pratt_string_index (MVMThreadContext *tc, MVMString *needle, MVMString *Haystack, MVMint64 H_offset);
+static void knuth_morris_pratt_process_pattern (MVMThreadContext *tc, void *n_blob, int n_is_8bit, MVMint16 *next, MVMStringIndex pat_graphs);
+static MVMint64 knuth_morris_pratt_search (MVMThreadContext *tc, MVMString *Haystack, MVMint64 H_offset, void *n_blob, int n_is_8bit, MVMStringIndex n_graphs, MVMint16 *next);
 
 /* Allocates strand storage. */
 static MVMStringStrand * allocate_strands(MVMThreadContext *tc, MVMuint16 num_strands) {
@@ -193,6 +195,42 @@ static void move_strands(MVMThreadContext *tc, const MVMString *from, MVMuint16
 MVM_STATIC_INLINE int can_fit_into_ascii (MVMGrapheme32 g) {
     return 0 <= g && g <= 127;
 }
+/* Returns the graphemes of a flat string if the len of them from start onwards
+ * are all in the ASCII range (so have no case change other than A-Z <-> a-z,
+ * no expansions and are their own base characters), and NULL otherwise. Only
+ * that part of the string is looked at. The pointer is to the first grapheme
+ * of the string, and may point into the string itself, so is only valid until
+ * the next allocation. */
+static MVMGrapheme8 * ascii_window(MVMThreadContext *tc, MVMString *s, MVMStringIndex start,
+        MVMStringIndex len) {
+    MVMGrapheme8  *blob;
+    MVMStringIndex i;
+    MVMGrapheme8   all = 0;
+    switch (s->body.storage_type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+            return s->body.storage.blob_8;
+        case MVM_STRING_GRAPHEME_8:
+            blob = s->body.storage.blob_8;
+            break;
+        case MVM_STRING_IN_SITU_8:
+            blob = s->body.storage.in_situ_8;
+            break;
+        default:
+            return NULL;
+    }
+    /* Negative 8 bit graphemes are synthetics. */
+    MVM_VECTORIZE_LOOP
+    for (i = start; i < start + len; i++)
+        all |= blob[i];
+    return all < 0 ? NULL : blob;
+}
+static MVMGrapheme8 * ascii_blob(MVMThreadContext *tc, MVMString *s) {
+    return ascii_window(tc, s, 0, MVM_string_graphs_nocheck(tc, s));
+}
+/* How many positions of an ASCII haystack are foldcased at a time when
+ * searching it ignoring case. */
+#define MVM_STRING_FOLD_CHUNK 4096
+#define ascii_fold(c) ((MVMGrapheme8)((MVMuint8)((c) - 'A') < 26 ? (c) + 0x20 : (c)))
 /* If a string is currently using 32bit storage, turn it into using
  * 8 bit storage. Doesn't do any checks at all. */
 static void turn_32bit_into_8bit_unchecked(MVMThreadContext *tc, MVMString *str) {
@@ -618,30 +656,106 @@ static MVMint64 MVM_string_memmem_grapheme32 (MVMThreadContext *tc, MVMGrapheme3
     MVMGrapheme32 * rtrn = memmem_uint32(H_blob32 + H_start, H_graphs - H_start, n_blob32, n_graphs);
     return rtrn == NULL ? -1 : rtrn - H_blob32;
 }
-static MVMint64 MVM_string_memmem_grapheme32str (MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 H_start, MVMStringIndex H_graphs, MVMStringIndex n_graphs) {
-    MVMGrapheme32 *needle_buf = NULL;
-    MVMint64 rtrn;
-    if (needle->body.storage_type != MVM_STRING_GRAPHEME_32) {
-        MVMStringIndex i;
-        size_t needle_size = n_graphs * sizeof(MVMGrapheme32);
-        /* We only get here in the n_graphs < 100 case in MVM_string_index, so it's safe to use alloca */
-        needle_buf = alloca(needle_size);
-        if (needle->body.storage_type != MVM_STRING_GRAPHEME_8) {
-            MVMGraphemeIter n_gi;
-            MVM_string_gi_init(tc, &n_gi, needle);
-            for (i = 0; i < n_graphs; i++) {
-                needle_buf[i] = MVM_string_gi_get_grapheme(tc, &n_gi);
-            }
+/* Needles up to this length are searched for in a haystack of a different
+ * storage width directly, using a first/last grapheme filter. Longer needles
+ * are converted to the haystack's width and searched for with memmem, since
+ * the two-way algorithm has better worst case behavior. */
+#define MVM_string_index_mixed_filter_max 64
+
+/* Gets a pointer to the graphemes of a flat string, and whether they are 8
+ * bit ones. The string must not be a strand. */
+MVM_STATIC_INLINE void * flat_blob(MVMString *s, int *is_8bit) {
+    switch (s->body.storage_type) {
+        case MVM_STRING_GRAPHEME_32:
+            *is_8bit = 0;
+            return s->body.storage.blob_32;
+        case MVM_STRING_IN_SITU_32:
+            *is_8bit = 0;
+            return s->body.storage.in_situ_32;
+        case MVM_STRING_IN_SITU_8:
+            *is_8bit = 1;
+            return s->body.storage.in_situ_8;
+        default:
+            *is_8bit = 1;
+            return s->body.storage.blob_8;
+    }
+}
+
+/* Searches the graphemes H_start up to H_end of a flat blob for a flat
+ * needle. Either may use 8 or 32 bit storage. Returns the index relative to
+ * the start of the blob, or -1 if the needle isn't found. */
+static MVMint64 string_index_flat(MVMThreadContext *tc, void *H_blob, int H_is_8bit,
+        MVMStringIndex H_start, MVMStringIndex H_end, void *n_blob, int n_is_8bit,
+        MVMStringIndex n_graphs) {
+    size_t H_len = H_end - H_start;
+    void  *found;
+    if (H_is_8bit) {
+        MVMGrapheme8 *H_blob8 = (MVMGrapheme8 *)H_blob;
+        if (n_is_8bit) {
+            found = MVM_memmem(H_blob8 + H_start, H_len, n_blob, n_graphs);
+        }
+        else if (n_graphs <= MVM_string_index_mixed_filter_max) {
+            found = memmem_uint8_uint32(H_blob8 + H_start, H_len, n_blob, n_graphs);
         }
         else {
-            for (i = 0; i < n_graphs; i++) {
-                needle_buf[i] = needle->body.storage.blob_8[i];
-            }
+            MVMGrapheme32 *n_blob32 = (MVMGrapheme32 *)n_blob;
+            MVMGrapheme8  *narrowed;
+            MVMStringIndex i;
+            /* If any grapheme of the needle needs 32 bits it can't match. */
+            if (!MVM_string_buf32_can_fit_into_8bit(n_blob32, n_graphs))
+                return -1;
+            narrowed = MVM_malloc(n_graphs * sizeof(MVMGrapheme8));
+            for (i = 0; i < n_graphs; i++)
+                narrowed[i] = n_blob32[i];
+            found = MVM_memmem(H_blob8 + H_start, H_len, narrowed, n_graphs);
+            MVM_free(narrowed);
+        }
+        return found == NULL ? -1 : (MVMGrapheme8 *)found - H_blob8;
+    }
+    else {
+        MVMGrapheme32 *H_blob32 = (MVMGrapheme32 *)H_blob;
+        if (!n_is_8bit) {
+            found = memmem_uint32(H_blob32 + H_start, H_len, n_blob, n_graphs);
+        }
+        else if (n_graphs <= MVM_string_index_mixed_filter_max) {
+            found = memmem_uint32_uint8(H_blob32 + H_start, H_len, n_blob, n_graphs);
+        }
+        else {
+            MVMGrapheme8  *n_blob8 = (MVMGrapheme8 *)n_blob;
+            MVMGrapheme32 *widened = MVM_malloc(n_graphs * sizeof(MVMGrapheme32));
+            MVMStringIndex i;
+            MVM_VECTORIZE_LOOP
+            for (i = 0; i < n_graphs; i++)
+                widened[i] = n_blob8[i];
+            found = memmem_uint32(H_blob32 + H_start, H_len, widened, n_graphs);
+            MVM_free(widened);
         }
+        return found == NULL ? -1 : (MVMGrapheme32 *)found - H_blob32;
     }
-    rtrn = MVM_string_memmem_grapheme32(tc, Haystack->body.storage.blob_32, needle_buf ? needle_buf : needle->body.storage.blob_32, H_start, H_graphs, n_graphs);
-    return rtrn;
 }
+
+/* Searches a haystack for a flat needle, if the haystack is a flat string or
+ * a view onto part of one (a single strand without repetitions). Returns -2
+ * if the haystack is made up of several strands, so the caller has to fall
+ * back to iterating it. */
+static MVMint64 string_index_flat_haystack(MVMThreadContext *tc, MVMString *Haystack,
+        MVMint64 start, void *n_blob, int n_is_8bit, MVMStringIndex n_graphs) {
+    int H_is_8bit;
+    if (Haystack->body.storage_type != MVM_STRING_STRAND) {
+        void *H_blob = flat_blob(Haystack, &H_is_8bit);
+        return string_index_flat(tc, H_blob, H_is_8bit, start,
+            MVM_string_graphs_nocheck(tc, Haystack), n_blob, n_is_8bit, n_graphs);
+    }
+    else if (Haystack->body.num_strands == 1 && !Haystack->body.storage.strands[0].repetitions) {
+        MVMStringStrand *strand = Haystack->body.storage.strands;
+        void *H_blob = flat_blob(strand->blob_string, &H_is_8bit);
+        MVMint64 index = string_index_flat(tc, H_blob, H_is_8bit, strand->start + start,
+            strand->end, n_blob, n_is_8bit, n_graphs);
+        return index == -1 ? -1 : index - strand->start;
+    }
+    return -2;
+}
+
 /* Returns the location of one string in another or -1  */
 MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start) {
     size_t index           = (size_t)start;
@@ -663,55 +777,36 @@ MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *Haystack, MVMString *
     if (H_graphs < n_graphs)
         return -1;
 
-    /* Fast paths when storage types are identical. Uses memmem function, which
-     * uses Knuth-Morris-Pratt algorithm on Linux and on others
-     * Crochemore+Perrin two-way string matching */
-    switch (Haystack->body.storage_type) {
-        case MVM_STRING_GRAPHEME_32:
-            if (needle->body.storage_type == MVM_STRING_GRAPHEME_32 || n_graphs < 100) {
-                return MVM_string_memmem_grapheme32str(tc, Haystack, needle, start, H_graphs, n_graphs);
-            }
-            break;
-        case MVM_STRING_GRAPHEME_8:
-            if (needle->body.storage_type == MVM_STRING_GRAPHEME_8 || n_graphs < 100) {
-                void         *mm_return_8 = NULL;
-                MVMGrapheme8 *needle_buf  = NULL;
-                if (needle->body.storage_type != MVM_STRING_GRAPHEME_8) {
-                    MVMStringIndex i;
-                    size_t needle_size = n_graphs * sizeof(MVMGrapheme8);
-                    /* We only get here in the n_graphs < 100 case, so it's safe to use alloca */
-                    needle_buf = alloca(needle_size);
-                    if (needle->body.storage_type != MVM_STRING_GRAPHEME_32) {
-                        MVMGraphemeIter n_gi;
-                        MVM_string_gi_init(tc, &n_gi, needle);
-                        for (i = 0; i < n_graphs; i++) {
-                            needle_buf[i] = MVM_string_gi_get_grapheme(tc, &n_gi);
-                        }
-                    }
-                    else {
-                        for (i = 0; i < n_graphs; i++) {
-                            MVMGrapheme32 g = needle->body.storage.blob_32[i];
-                            /* Haystack is 8 bit, needle is 32 bit. if we encounter a non8bit grapheme
-                             * it's impossible to match */
-                            if (!can_fit_into_8bit(g)) {
-                                return -1;
-                            }
-                            needle_buf[i] = g;
-                        }
-                    }
-                }
-                mm_return_8 = MVM_memmem(
-                    Haystack->body.storage.blob_8 + start, /* start position */
-                    (H_graphs - start) * sizeof(MVMGrapheme8), /* length of Haystack from start position to end */
-                    needle_buf ? needle_buf : needle->body.storage.blob_8, /* needle start */
-                    n_graphs * sizeof(MVMGrapheme8) /* needle length */
-                );
-                if (mm_return_8 == NULL)
-                    return -1;
-                else
-                    return (MVMGrapheme8*)mm_return_8 -  Haystack->body.storage.blob_8;
-            }
-            break;
+    /* Fast paths for flat haystacks (or views onto a flat string), whatever
+     * the storage width of haystack and needle. Same width searches use
+     * memmem, which uses Knuth-Morris-Pratt algorithm on Linux and on others
+     * Crochemore+Perrin two-way string matching. */
+    if (Haystack->body.storage_type != MVM_STRING_STRAND
+            || (Haystack->body.num_strands == 1 && !Haystack->body.storage.strands[0].repetitions)) {
+        MVMint64 result;
+        if (needle->body.storage_type != MVM_STRING_STRAND) {
+            int   n_is_8bit;
+            void *n_blob = flat_blob(needle, &n_is_8bit);
+            result = string_index_flat_haystack(tc, Haystack, start, n_blob, n_is_8bit, n_graphs);
+        }
+        else {
+            /* Flatten a strand needle into a buffer. */
+            MVMGrapheme32  *needle_buf;
+            MVMGraphemeIter n_gi;
+            MVMStringIndex  i;
+            int             needle_buf_is_malloced = n_graphs >= 100;
+            /* Only use alloca for small needles */
+            needle_buf = needle_buf_is_malloced
+                ? MVM_malloc(n_graphs * sizeof(MVMGrapheme32))
+                : alloca(n_graphs * sizeof(MVMGrapheme32));
+            MVM_string_gi_init(tc, &n_gi, needle);
+            for (i = 0; i < n_graphs; i++)
+                needle_buf[i] = MVM_string_gi_get_grapheme(tc, &n_gi);
+            result = string_index_flat_haystack(tc, Haystack, start, needle_buf, 0, n_graphs);
+            if (needle_buf_is_malloced)
+                MVM_free(needle_buf);
+        }
+        return result;
     }
     /* Minimal code version for needles of size 1 */
     if (n_graphs == 1) {
@@ -748,6 +843,95 @@ MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *Haystack, MVMString *
     return -1;
 }
 
+/* Prepares a needle for repeated searches with MVM_string_index_prepared. The
+ * needle's graphemes are copied out, so the MVMStringSearchNeedle does not
+ * hold any reference to the string and doesn't need rooting. */
+void MVM_string_search_needle_init(MVMThreadContext *tc, MVMStringSearchNeedle *sn, MVMString *needle) {
+    MVMStringIndex  n_graphs;
+    MVMGraphemeIter n_gi;
+    MVMStringIndex  i;
+    MVM_string_check_arg(tc, needle, "index search term");
+    n_graphs    = MVM_string_graphs_nocheck(tc, needle);
+    sn->graphs  = n_graphs;
+    sn->blob_32 = MVM_malloc((n_graphs ? n_graphs : 1) * sizeof(MVMGrapheme32));
+    sn->blob_8  = NULL;
+    sn->kmp_next = NULL;
+    MVM_string_gi_init(tc, &n_gi, needle);
+    for (i = 0; i < n_graphs; i++)
+        sn->blob_32[i] = MVM_string_gi_get_grapheme(tc, &n_gi);
+    if (MVM_string_buf32_can_fit_into_8bit(sn->blob_32, n_graphs)) {
+        sn->blob_8 = MVM_malloc((n_graphs ? n_graphs : 1) * sizeof(MVMGrapheme8));
+        for (i = 0; i < n_graphs; i++)
+            sn->blob_8[i] = sn->blob_32[i];
+    }
+}
+
+/* Frees the memory held by a prepared needle. */
+void MVM_string_search_needle_destroy(MVMThreadContext *tc, MVMStringSearchNeedle *sn) {
+    MVM_free(sn->blob_32);
+    MVM_free(sn->blob_8);
+    MVM_free(sn->kmp_next);
+    sn->blob_32  = NULL;
+    sn->blob_8   = NULL;
+    sn->kmp_next = NULL;
+}
+
+/* Like MVM_string_index, but with a needle prepared by
+ * MVM_string_search_needle_init. */
+MVMint64 MVM_string_index_prepared(MVMThreadContext *tc, MVMString *Haystack, MVMStringSearchNeedle *sn, MVMint64 start) {
+    MVMStringIndex H_graphs, n_graphs = sn->graphs;
+    MVMint64       result;
+    MVM_string_check_arg(tc, Haystack, "index search target");
+    H_graphs = MVM_string_graphs_nocheck(tc, Haystack);
+
+    if (!n_graphs)
+        return start <= H_graphs ? start : -1; /* the empty string is in any other string */
+
+    if (!H_graphs || start < 0 || H_graphs <= start || H_graphs < n_graphs)
+        return -1;
+
+    /* Search with whichever copy of the needle matches the haystack's width,
+     * so there's never any widening or narrowing to do. */
+    if (Haystack->body.storage_type != MVM_STRING_STRAND
+            || (Haystack->body.num_strands == 1 && !Haystack->body.storage.strands[0].repetitions)) {
+        MVMString *flat = Haystack->body.storage_type == MVM_STRING_STRAND
+            ? Haystack->body.storage.strands[0].blob_string
+            : Haystack;
+        int H_is_8bit;
+        flat_blob(flat, &H_is_8bit);
+        if (H_is_8bit && !sn->blob_8)
+            return -1;
+        return string_index_flat_haystack(tc, Haystack, start,
+            H_is_8bit ? (void *)sn->blob_8 : (void *)sn->blob_32, H_is_8bit, n_graphs);
+    }
+
+    /* Haystacks made of multiple strands are searched with Knuth-Morris-Pratt
+     * over a cached grapheme iterator; the jump table is computed on the
+     * first such search and kept with the needle. */
+    if (n_graphs <= MVM_string_KMP_max_pattern_length) {
+        if (!sn->kmp_next) {
+            sn->kmp_next = MVM_malloc((1 + n_graphs) * sizeof(MVMint16));
+            knuth_morris_pratt_process_pattern(tc, sn->blob_32, 0, sn->kmp_next, n_graphs);
+        }
+        return knuth_morris_pratt_search(tc, Haystack, start, sn->blob_32, 0, n_graphs, sn->kmp_next);
+    }
+    else {
+        MVMGraphemeIter_cached H_gic;
+        MVMint64 index;
+        MVM_string_gi_cached_init(tc, &H_gic, Haystack, start);
+        result = -1;
+        for (index = start; result == -1 && index <= H_graphs - n_graphs; index++) {
+            MVMStringIndex i;
+            for (i = 0; i < n_graphs; i++)
+                if (MVM_string_gi_cached_get_grapheme(tc, &H_gic, index + i) != sn->blob_32[i])
+                    break;
+            if (i == n_graphs)
+                result = index;
+        }
+        return result;
+    }
+}
+
 /* Returns the location of one string in another or -1  */
 MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start) {
     MVMint64 result = -1;
@@ -1359,6 +1543,27 @@ static MVMint64 string_equal_at_ignore_case(MVMThreadContext *tc, MVMString *Hay
      * can't assume too much. If optimizing this be careful */
     if (H_graphs < H_offset)
         return 0;
+    /* If the needle and the part of the haystack it is compared with are all
+     * ASCII, nothing expands, so we can compare folding as we go rather than
+     * producing a foldcased needle. */
+    if (Haystack->body.storage_type != MVM_STRING_STRAND && needle->body.storage_type != MVM_STRING_STRAND) {
+        MVMGrapheme8  *n_ascii  = ascii_blob(tc, needle);
+        MVMStringIndex n_graphs = MVM_string_graphs_nocheck(tc, needle);
+        MVMStringIndex H_len    = H_graphs - H_offset < n_graphs ? H_graphs - H_offset : n_graphs;
+        MVMGrapheme8  *H_ascii  = n_ascii ? ascii_window(tc, Haystack, H_offset, H_len) : NULL;
+        if (H_ascii) {
+            MVMStringIndex i;
+            if (H_len < n_graphs)
+                return 0;
+            H_ascii += H_offset;
+            if (!ignorecase)
+                return 0 == memcmp(H_ascii, n_ascii, n_graphs);
+            for (i = 0; i < n_graphs; i++)
+                if (ascii_fold(H_ascii[i]) != ascii_fold(n_ascii[i]))
+                    return 0;
+            return 1;
+        }
+    }
     MVMROOT(tc, Haystack) {
         needle_fc = ignorecase ? MVM_string_fc(tc, needle) : needle;
     }
@@ -1375,71 +1580,47 @@ static MVMint64 string_equal_at_ignore_case(MVMThreadContext *tc, MVMString *Hay
         return n_fc_graphs <= H_graphs + H_expansion - H_offset ? 1 : 0;
     return 0;
 }
+/* Gets a grapheme of a flat needle's blob. */
+MVM_STATIC_INLINE MVMGrapheme32 kmp_needle_at(void *n_blob, int n_is_8bit, MVMint64 i) {
+    return n_is_8bit ? ((MVMGrapheme8 *)n_blob)[i] : ((MVMGrapheme32 *)n_blob)[i];
+}
 /* Processes the pattern. The pattern must be able to store negative and positive
  * numbers. It must be able to store at least 1/2 the length of the needle,
  * though possibly more (though I am not sure it's possible for it to be more than
  * 1/2). */
-static void knuth_morris_pratt_process_pattern (MVMThreadContext *tc, MVMString *pat, MVMint16 *next, MVMStringIndex pat_graphs) {
+static void knuth_morris_pratt_process_pattern (MVMThreadContext *tc, void *n_blob, int n_is_8bit, MVMint16 *next, MVMStringIndex pat_graphs) {
     MVMint64 i = 0;
     MVMint64 j = next[0] = -1;
     while (i < pat_graphs) {
-        if (j == -1 || MVM_string_get_grapheme_at_nocheck(tc, pat, i)
-                    == MVM_string_get_grapheme_at_nocheck(tc, pat, j)) {
+        if (j == -1 || kmp_needle_at(n_blob, n_is_8bit, i)
+                    == kmp_needle_at(n_blob, n_is_8bit, j)) {
             i++; j++;
             next[i] = (i < pat_graphs
-            && MVM_string_get_grapheme_at_nocheck(tc, pat, j)
-            == MVM_string_get_grapheme_at_nocheck(tc, pat, i))
+            && kmp_needle_at(n_blob, n_is_8bit, j)
+            == kmp_needle_at(n_blob, n_is_8bit, i))
                 ? next[j]
                 : j;
         }
         else j = next[j];
     }
 }
-
-static MVMint64 knuth_morris_pratt_string_index (MVMThreadContext *tc, MVMString *needle, MVMString *Haystack, MVMint64 H_offset) {
+/* Searches for a needle, given as a flat blob, using the jump table made for
+ * it by knuth_morris_pratt_process_pattern. */
+static MVMint64 knuth_morris_pratt_search (MVMThreadContext *tc, MVMString *Haystack, MVMint64 H_offset, void *n_blob, int n_is_8bit, MVMStringIndex n_graphs, MVMint16 *next) {
     MVMint64 needle_offset = 0;
     MVMint64 text_offset   = H_offset;
     MVMStringIndex Haystack_graphs = MVM_string_graphs_nocheck(tc, Haystack);
-    MVMStringIndex needle_graphs   = MVM_string_graphs_nocheck(tc, needle);
-    MVMint16         *next = NULL;
-    MVMString *flat_needle = NULL;
-    size_t next_size = (1 + needle_graphs) * sizeof(MVMint16);
-    int    next_is_malloced = 0;
-    assert(needle_graphs <= MVM_string_KMP_max_pattern_length);
-    /* Empty string is found at start of string */
-    if (needle_graphs == 0)
-        return 0;
-    /* Allocate max 3K onto the stack, otherwise malloc */
-    if (next_size < 3000)
-        next = alloca(next_size);
-    else {
-        next = MVM_malloc(next_size);
-        next_is_malloced = 1;
-    }
-    /* If the needle is a strand, flatten it, otherwise use the original string */
-    if (needle->body.storage_type == MVM_STRING_STRAND) {
-        MVMROOT(tc, Haystack) {
-            flat_needle = collapse_strands(tc, needle);
-        }
-    }
-    else {
-        flat_needle = needle;
-    }
-    /* Process the needle into a jump table put into variable 'next' */
-    knuth_morris_pratt_process_pattern(tc, flat_needle, next, needle_graphs);
     /* If the Haystack is a strand, use MVM_string_gi_cached_get_grapheme
      * since it retains its grapheme iterator over invocations unlike
      * MVM_string_get_grapheme_at_nocheck and caches the previous grapheme. It
      * is slower for flat Haystacks though. */
     #define MVM_kmp_loop(Haystack_function) {\
-        while (text_offset < Haystack_graphs && needle_offset < needle_graphs) {\
-            if (needle_offset == -1 || MVM_string_get_grapheme_at_nocheck(tc, flat_needle, needle_offset)\
+        while (text_offset < Haystack_graphs && needle_offset < n_graphs) {\
+            if (needle_offset == -1 || kmp_needle_at(n_blob, n_is_8bit, needle_offset)\
                                     == (Haystack_function)) {\
                 text_offset++; needle_offset++;\
-                if (needle_offset == needle_graphs) {\
-                    if (next_is_malloced) MVM_free(next);\
+                if (needle_offset == n_graphs)\
                     return text_offset - needle_offset;\
-                }\
             }\
             else needle_offset = next[needle_offset];\
         }\
@@ -1452,9 +1633,44 @@ static MVMint64 knuth_morris_pratt_string_index (MVMThreadContext *tc, MVMString
     else {
         MVM_kmp_loop(MVM_string_get_grapheme_at_nocheck(tc, Haystack, text_offset));
     }
-    if (next_is_malloced) MVM_free(next);
     return -1;
 }
+static MVMint64 knuth_morris_pratt_string_index (MVMThreadContext *tc, MVMString *needle, MVMString *Haystack, MVMint64 H_offset) {
+    MVMStringIndex needle_graphs   = MVM_string_graphs_nocheck(tc, needle);
+    MVMint16         *next = NULL;
+    MVMString *flat_needle = NULL;
+    void      *n_blob;
+    int        n_is_8bit;
+    MVMint64   result;
+    size_t next_size = (1 + needle_graphs) * sizeof(MVMint16);
+    int    next_is_malloced = 0;
+    assert(needle_graphs <= MVM_string_KMP_max_pattern_length);
+    /* Empty string is found at start of string */
+    if (needle_graphs == 0)
+        return 0;
+    /* If the needle is a strand, flatten it, otherwise use the original string */
+    if (needle->body.storage_type == MVM_STRING_STRAND) {
+        MVMROOT(tc, Haystack) {
+            flat_needle = collapse_strands(tc, needle);
+        }
+    }
+    else {
+        flat_needle = needle;
+    }
+    /* Allocate max 3K onto the stack, otherwise malloc */
+    if (next_size < 3000)
+        next = alloca(next_size);
+    else {
+        next = MVM_malloc(next_size);
+        next_is_malloced = 1;
+    }
+    /* Process the needle into a jump table put into variable 'next' */
+    n_blob = flat_blob(flat_needle, &n_is_8bit);
+    knuth_morris_pratt_process_pattern(tc, n_blob, n_is_8bit, next, needle_graphs);
+    result = knuth_morris_pratt_search(tc, Haystack, H_offset, n_blob, n_is_8bit, needle_graphs, next);
+    if (next_is_malloced) MVM_free(next);
+    return result;
+}
 static MVMint64 string_index_ignore_case(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start, int ignoremark, int ignorecase) {
     /* Foldcase version of needle */
     MVMString *needle_fc = NULL;
@@ -1486,6 +1702,44 @@ static MVMint64 string_index_ignore_case(MVMThreadContext *tc, MVMString *Haysta
         needle_fc = ignorecase ? MVM_string_fc(tc, needle) : needle;
     }
     n_fc_graphs = MVM_string_graphs(tc, needle_fc);
+    /* ASCII parts of the haystack don't expand when foldcased and their
+     * graphemes are their own base characters, so we can foldcase them a
+     * chunk at a time and search that with memmem, stopping at the first
+     * match. Should we reach graphemes that aren't ASCII, the search goes on
+     * from there the slow way. With ignoremark, this only works if the needle
+     * is all ASCII too. */
+    if (Haystack->body.storage_type != MVM_STRING_STRAND && needle_fc->body.storage_type != MVM_STRING_STRAND
+            && n_fc_graphs <= H_graphs - start
+            && (!ignoremark || ascii_blob(tc, needle_fc))) {
+        MVMStringIndex  chunk = H_graphs - start < MVM_STRING_FOLD_CHUNK + n_fc_graphs - 1
+            ? H_graphs - start : MVM_STRING_FOLD_CHUNK + n_fc_graphs - 1;
+        MVMGrapheme8   *H_fc  = MVM_malloc(chunk * sizeof(MVMGrapheme8));
+        int   n_is_8bit;
+        void *n_blob = flat_blob(needle_fc, &n_is_8bit);
+        while (index + n_fc_graphs <= H_graphs) {
+            MVMStringIndex  H_len   = H_graphs - index < chunk ? H_graphs - index : chunk;
+            MVMGrapheme8   *H_ascii = ascii_window(tc, Haystack, index, H_len);
+            MVMStringIndex  i;
+            MVMint64 result;
+            if (!H_ascii)
+                break;
+            if (ignorecase) {
+                MVM_VECTORIZE_LOOP
+                for (i = 0; i < H_len; i++)
+                    H_fc[i] = ascii_fold(H_ascii[index + i]);
+            }
+            else {
+                memcpy(H_fc, H_ascii + index, H_len);
+            }
+            result = string_index_flat(tc, H_fc, 1, 0, H_len, n_blob, n_is_8bit, n_fc_graphs);
+            if (result != -1) {
+                MVM_free(H_fc);
+                return index + result;
+            }
+            index += H_len - n_fc_graphs + 1;
+        }
+        MVM_free(H_fc);
+    }
     /* brute force for now. horrible, yes. halp. */
     if (is_gic) {
         Hs_or_gic = alloca(sizeof(MVMGraphemeIter_cached));
@@ -1560,6 +1814,8 @@ MVMint64 MVM_string_equal(MVMThreadContext *tc, MVMString *a, MVMString *b) {
 
     if (a == b)
         return 1;
+    if (MVM_string_both_interned(a, b))
+        return 0;
 
     agraphs = MVM_string_graphs_nocheck(tc, a);
     bgraphs = MVM_string_graphs_nocheck(tc, b);
@@ -1574,6 +1830,76 @@ MVMint64 MVM_string_equal(MVMThreadContext *tc, MVMString *a, MVMString *b) {
     return MVM_string_substrings_equal_nocheck(tc, a, 0, bgraphs, b, 0);
 }
 
+/* Interns a string: returns the interned string with the same value as s,
+ * making one if there is none yet. Interned strings live in gen2 and are
+ * flat; if s is already both then it becomes the interned string itself,
+ * otherwise a copy does. As there is only ever one interned string per value,
+ * two interned strings are equal only if they are the same object. */
+MVMString * MVM_string_intern(MVMThreadContext *tc, MVMString *s) {
+    struct MVMStrHashHandle *entry;
+    MVMString *interned;
+
+    MVM_string_check_arg(tc, s, "intern");
+    if (s->common.header.flags1 & MVM_CF_INTERNED_STRING)
+        return s;
+
+    /* Compute the hash code outside of the lock; it is cached on s and then
+     * carried over to any copy we make. */
+    MVM_string_hash_code(tc, s);
+
+    uv_mutex_lock(&tc->instance->mutex_interned_strings);
+    entry = MVM_str_hash_lvalue_fetch_nocheck(tc, &tc->instance->interned_strings, s);
+    if (!entry->key) {
+        if (s->body.storage_type != MVM_STRING_STRAND
+                && (s->common.header.flags2 & MVM_CF_SECOND_GEN)) {
+            interned = s;
+        }
+        else {
+            /* Allocating in gen2 can never trigger a GC, which would
+             * deadlock trying to clean up the table while we hold its
+             * mutex. */
+            MVM_gc_allocate_gen2_default_set(tc);
+            interned = s->body.storage_type == MVM_STRING_STRAND
+                ? collapse_strands(tc, s)
+                : (MVMString *)MVM_repr_clone(tc, (MVMObject *)s);
+            MVM_gc_allocate_gen2_default_clear(tc);
+            interned->body.cached_hash_code = s->body.cached_hash_code;
+        }
+        interned->common.header.flags1 |= MVM_CF_INTERNED_STRING;
+        entry->key = interned;
+    }
+    else {
+        interned = entry->key;
+    }
+    uv_mutex_unlock(&tc->instance->mutex_interned_strings);
+
+    return interned;
+}
+
+/* The interned strings table does not mark its keys. This is called by the
+ * GC co-ordinator after a full collection has marked everything, but before
+ * gen2 is swept, and removes the interned strings that were not found to be
+ * alive. They have not been freed yet, so the table can still look at them
+ * while deleting. */
+void MVM_string_intern_cleanup(MVMThreadContext *tc) {
+    MVMStrHashTable *table = &tc->instance->interned_strings;
+    MVMStrHashIterator iterator;
+    MVM_VECTOR_DECL(MVMString *, dead);
+    size_t i;
+
+    MVM_VECTOR_INIT(dead, 0);
+    iterator = MVM_str_hash_first(tc, table);
+    while (!MVM_str_hash_at_end(tc, table, iterator)) {
+        struct MVMStrHashHandle *current = MVM_str_hash_current_nocheck(tc, table, iterator);
+        if (!(current->key->common.header.flags2 & MVM_CF_GEN2_LIVE))
+            MVM_VECTOR_PUSH(dead, current->key);
+        iterator = MVM_str_hash_next_nocheck(tc, table, iterator);
+    }
+    for (i = 0; i < MVM_VECTOR_ELEMS(dead); i++)
+        MVM_str_hash_delete_nocheck(tc, table, dead[i]);
+    MVM_VECTOR_DESTROY(dead);
+}
+
 /* more general form of has_at; compares two substrings for equality */
 MVMint64 MVM_string_have_at(MVMThreadContext *tc, MVMString *a,
         MVMint64 starta, MVMint64 length, MVMString *b, MVMint64 startb) {
@@ -1624,10 +1950,44 @@ MVMint64 MVM_string_index_of_grapheme(MVMThreadContext *tc, MVMString *a, MVMGra
 
 /* Case change functions. */
 MVMint64 MVM_string_grapheme_is_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMGrapheme32 g);
+/* Changes the case of a string made up of only ASCII graphemes, where there's
+ * no need to look up any case change properties. The result is an ASCII
+ * string too; if nothing changed, the original string is returned. */
+static MVMString * do_ascii_case_change(MVMThreadContext *tc, MVMString *s, MVMGrapheme8 *in, MVMStringIndex graphs, MVMint32 type) {
+    MVMGrapheme8  *out = MVM_malloc(graphs * sizeof(MVMGrapheme8));
+    MVMGrapheme8   changed = 0;
+    MVMStringIndex i;
+    if (type == MVM_unicode_case_change_type_upper || type == MVM_unicode_case_change_type_title) {
+        MVM_VECTORIZE_LOOP
+        for (i = 0; i < graphs; i++) {
+            MVMGrapheme8 flip = (MVMuint8)(in[i] - 'a') < 26 ? 0x20 : 0;
+            out[i]   = in[i] ^ flip;
+            changed |= flip;
+        }
+    }
+    else {
+        MVM_VECTORIZE_LOOP
+        for (i = 0; i < graphs; i++) {
+            MVMGrapheme8 flip = (MVMuint8)(in[i] - 'A') < 26 ? 0x20 : 0;
+            out[i]   = in[i] ^ flip;
+            changed |= flip;
+        }
+    }
+    if (!changed) {
+        MVM_free(out);
+        return s;
+    }
+    return MVM_string_ascii_from_buf_nocheck(tc, out, graphs);
+}
 static MVMString * do_case_change(MVMThreadContext *tc, MVMString *s, MVMint32 type, char *error) {
     MVMint64 sgraphs;
     MVM_string_check_arg(tc, s, error);
     sgraphs = MVM_string_graphs_nocheck(tc, s);
+    if (sgraphs) {
+        MVMGrapheme8 *ascii = ascii_blob(tc, s);
+        if (ascii)
+            return do_ascii_case_change(tc, s, ascii, sgraphs, type);
+    }
     if (sgraphs) {
         MVMString *result;
         MVMGraphemeIter gi;
@@ -1965,42 +2325,61 @@ MVMString * MVM_string_decode_from_buf(MVMThreadContext *tc, MVMObject *buf, MVM
 
 MVMObject * MVM_string_split(MVMThreadContext *tc, MVMString *separator, MVMString *input) {
     MVMObject *result = NULL;
+    MVMObject *found  = NULL;
     MVMStringIndex start, end, sep_length;
     MVMHLLConfig *hll = MVM_hll_current(tc);
+    MVMStringSearchNeedle sep_needle;
+    MVMint64 i, num_found;
 
     MVM_string_check_arg(tc, separator, "split separator");
     MVM_string_check_arg(tc, input, "split input");
 
-    MVMROOT3(tc, input, separator, result) {
+    /* The separator is searched for over and over, so prepare it once. All
+     * the searching is done up front, collecting where the separators are,
+     * as making the pieces may throw and nothing would free it then. */
+    MVMROOT2(tc, separator, input) {
+        found = MVM_repr_alloc_init(tc, tc->instance->boot_types.BOOTIntArray);
+    }
+    MVM_string_search_needle_init(tc, &sep_needle, separator);
+    start = 0;
+    end = MVM_string_graphs_nocheck(tc, input);
+    sep_length = sep_needle.graphs;
+    while (sep_length && start < end) {
+        MVMint64 index = MVM_string_index_prepared(tc, input, &sep_needle, start);
+        if (index == -1)
+            break;
+        MVM_repr_push_i(tc, found, index);
+        start = index + sep_length;
+    }
+    MVM_string_search_needle_destroy(tc, &sep_needle);
+
+    MVMROOT3(tc, input, found, result) {
         result = MVM_repr_alloc_init(tc, hll->slurpy_array_type);
+        num_found = MVM_repr_elems(tc, found);
         start = 0;
-        end = MVM_string_graphs_nocheck(tc, input);
-        sep_length = MVM_string_graphs_nocheck(tc, separator);
 
-        while (start < end) {
+        /* With a separator, there's a piece before each one, and one after
+         * the last, unless the input was empty; without, each grapheme is a
+         * piece. */
+        for (i = 0; sep_length ? i <= num_found : start < end; i++) {
             MVMString *portion;
-            MVMStringIndex index;
             MVMStringIndex length;
 
-            /* XXX make this use the dual-traverse iterator, but such that it
-                can reset the index of what it's comparing... <!> */
-            index = MVM_string_index(tc, input, separator, start);
-            length = sep_length ? (index == (MVMStringIndex)-1 ? end : index) - start : 1;
-            if (0 < length || (sep_length && length == 0)) {
-                portion = MVM_string_substring(tc, input, start, length);
-                MVMROOT(tc, portion) {
-                    MVMObject *pobj = MVM_repr_alloc_init(tc, hll->str_box_type);
-                    MVM_repr_set_str(tc, pobj, portion);
-                    MVM_repr_push_o(tc, result, pobj);
-                }
+            if (sep_length) {
+                if (i == num_found && start == end && !num_found)
+                    break;
+                length = (i < num_found ? MVM_repr_at_pos_i(tc, found, i) : end) - start;
             }
-            start += length + sep_length;
-            /* Gather an empty string if the delimiter is found at the end. */
-            if (sep_length && start == end) {
+            else {
+                length = 1;
+            }
+            portion = MVM_string_substring(tc, input, start, length);
+            MVMROOT(tc, portion) {
                 MVMObject *pobj = MVM_repr_alloc_init(tc, hll->str_box_type);
-                MVM_repr_set_str(tc, pobj, tc->instance->str_consts.empty);
+                MVM_repr_set_str(tc, pobj, portion);
                 MVM_repr_push_o(tc, result, pobj);
             }
+            start += length + sep_length;
         }
     }
 
@@ -76,20 +76,50 @@ MVM_STATIC_INLINE int MVM_string_buf32_can_fit_into_8bit(MVMGrapheme32 *active_b
     return val ? 0 : 1;
 }
 
+/* Interned strings are unique by value, so two different interned strings
+ * are never equal. */
+MVM_STATIC_INLINE int MVM_string_both_interned(MVMString *a, MVMString *b) {
+    return a->common.header.flags1 & b->common.header.flags1 & MVM_CF_INTERNED_STRING;
+}
+
 MVMuint64 MVM_string_compute_hash_code(MVMThreadContext *tc, MVMString *s);
 MVM_STATIC_INLINE MVMuint64 MVM_string_hash_code(MVMThreadContext *tc, MVMString *s) {
     return s->body.cached_hash_code ? s->body.cached_hash_code
         : MVM_string_compute_hash_code(tc, s);
 }
 
+/* A needle prepared for repeated searches with MVM_string_index_prepared. The
+ * graphemes are flattened out once up front, in both widths if the needle
+ * fits into 8 bits, so each search can go straight to the memmem routine that
+ * matches the haystack's storage. */
+struct MVMStringSearchNeedle {
+    /* The needle's graphemes. */
+    MVMGrapheme32 *blob_32;
+
+    /* The needle's graphemes as 8 bit ones, or NULL if any doesn't fit. */
+    MVMGrapheme8 *blob_8;
+
+    /* Knuth-Morris-Pratt jump table, computed on demand for searches of
+     * haystacks made of multiple strands. */
+    MVMint16 *kmp_next;
+
+    /* The number of graphemes in the needle. */
+    MVMStringIndex graphs;
+};
+
 MVMGrapheme32 MVM_string_get_grapheme_at_nocheck(MVMThreadContext *tc, MVMString *a, MVMint64 index);
 MVMint64 MVM_string_equal(MVMThreadContext *tc, MVMString *a, MVMString *b);
+MVMString * MVM_string_intern(MVMThreadContext *tc, MVMString *s);
+void MVM_string_intern_cleanup(MVMThreadContext *tc);
 MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
         MVMint64 starta, MVMint64 length, MVMString *b, MVMint64 startb);
 MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start);
 MVMint64 MVM_string_index_ignore_case(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start);
 MVMint64 MVM_string_index_ignore_mark(MVMThreadContext *tc, MVMString *Haystack, MVMString *needle, MVMint64 start);
 MVMint64 MVM_string_index_ignore_case_ignore_mark(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start);
+void MVM_string_search_needle_init(MVMThreadContext *tc, MVMStringSearchNeedle *sn, MVMString *needle);
+MVMint64 MVM_string_index_prepared(MVMThreadContext *tc, MVMString *haystack, MVMStringSearchNeedle *sn, MVMint64 start);
+void MVM_string_search_needle_destroy(MVMThreadContext *tc, MVMStringSearchNeedle *sn);
 MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start);
 MVMString * MVM_string_concatenate(MVMThreadContext *tc, MVMString *a, MVMString *b);
 MVMString * MVM_string_repeat(MVMThreadContext *tc, MVMString *a, MVMint64 count);
@@ -504,8 +504,8 @@ static MVMint64 collation_return_by_quaternary(MVMThreadContext *tc, level_eval
                                      level_eval_settings->s.quaternary.s2.Same ;
     }
 }
-/* MVM_unicode_string_compare implements the Unicode Collation Algorthm */
-MVMint64 MVM_unicode_string_compare(MVMThreadContext *tc, MVMString *a, MVMString *b,
+/* collation_compare implements the Unicode Collation Algorthm */
+static MVMint64 collation_compare(MVMThreadContext *tc, MVMString *a, MVMString *b,
          MVMint64 collation_mode, MVMint64 lang_mode, MVMint64 country_mode) {
     MVMStringIndex alen, blen;
     /* Iteration variables */
@@ -675,6 +675,170 @@ MVMint64 MVM_unicode_string_compare(MVMThreadContext *tc, MVMString *a, MVMStrin
     return collation_return_by_quaternary(tc, &level_eval_settings, alen, blen, compare_by_cp_rtrn);
 }
 
+/* Collation keys are written out as digits of 6 bits each, using the
+ * printable ASCII characters from '?' to '~', so that the key is a plain
+ * ASCII string and comparing two keys by codepoint gives their collation
+ * order. */
+#define collation_key_digit_bits 6
+#define collation_key_digit_max  63
+#define collation_key_digit_base '?'
+struct collation_key_buf {
+    MVMGrapheme8 *digits;
+    MVMuint32     used;
+    MVMuint32     size;
+};
+static void collation_key_emit(MVMThreadContext *tc, struct collation_key_buf *buf,
+        MVMuint64 value, MVMuint32 num_digits, MVMint32 reverse) {
+    if (buf->size < buf->used + num_digits) {
+        buf->size  = (buf->size + num_digits) * 2;
+        buf->digits = MVM_realloc(buf->digits, buf->size);
+    }
+    while (num_digits--) {
+        MVMuint32 digit = (value >> (num_digits * collation_key_digit_bits)) & collation_key_digit_max;
+        if (reverse)
+            digit = collation_key_digit_max - digit;
+        buf->digits[buf->used++] = collation_key_digit_base + digit;
+    }
+}
+/* The largest collation value that can be on a stack; values are one more
+ * than the DUCET ones, which are 16 bit. */
+#define collation_value_max 0x10000
+/* What stands in the key for each value on a disabled level. */
+#define collation_key_disabled_marker 1
+/* Computes a sort key for a string under the given collation_mode (with the
+ * same meaning as for MVM_unicode_string_compare). Two keys compare with
+ * MVM_string_compare (or memcmp) the way the strings they came from compare
+ * with MVM_unicode_string_compare, so the collation elements of each string
+ * only need deriving once when sorting.
+ *
+ * The key holds, for each enabled level, the non-ignorable collation values
+ * followed by a level separator, then, if the quaternary level is enabled,
+ * the codepoints, a terminator and the number of graphemes to break ties.
+ * Reversed levels have their values subtracted from the maximum.
+ *
+ * A primary or secondary level that is neither enabled nor reversed still
+ * matters to the comparison: it steps through the two strings' values on the
+ * level together, and when one string runs out first it goes on to compare
+ * its next level's values, which are all lower, against the other string's
+ * values on this level. So the string with fewer values on the level comes
+ * first, and the key has a fixed marker for each value and then the level
+ * separator. (If it has just one value fewer, the comparison instead puts
+ * its next level's first value against the other string's level separator,
+ * and it comes last; that doesn't give a consistent order, so keys don't
+ * reproduce it.) A tertiary level that is disabled is left out, as running
+ * out on it goes straight to the quaternary level.
+ *
+ * Keys are only comparable with keys made with the same modes. */
+MVMString * MVM_unicode_string_collation_key(MVMThreadContext *tc, MVMString *s,
+         MVMint64 collation_mode, MVMint64 lang_mode, MVMint64 country_mode) {
+    struct collation_key_buf buf;
+    collation_stack stack;
+    MVMCodepointIter ci;
+    MVMStringIndex graphs;
+    MVMint32 level_dir[4];
+    MVMint32 level;
+    MVM_string_check_arg(tc, s, "collation key");
+    graphs = MVM_string_graphs_nocheck(tc, s);
+
+    /* 1 for an enabled level, -1 for a reversed one, 0 for a disabled one. */
+    for (level = 0; level < 4; level++) {
+        MVMint64 positive = collation_mode & (1 << (level * 2));
+        MVMint64 negative = collation_mode & (2 << (level * 2));
+        level_dir[level] = positive && !negative ? 1 : negative && !positive ? -1 : 0;
+    }
+
+    buf.used   = 0;
+    buf.size   = 16 + graphs * 4;
+    buf.digits = MVM_malloc(buf.size);
+
+    /* MVM_unicode_string_compare decides a comparison with the empty string
+     * on the quaternary level alone, so it sorts before (or with a reversed
+     * quaternary level, after) everything else. Without a quaternary level it
+     * compares the same as anything, which no key can reproduce; it gets the
+     * key of a string of only ignorable characters, the strings it compares
+     * the same as in a consistent order. */
+    if (!graphs && level_dir[3]) {
+        collation_key_emit(tc, &buf, 1 - level_dir[3], 1, 0);
+        return MVM_string_ascii_from_buf_nocheck(tc, buf.digits, buf.used);
+    }
+    collation_key_emit(tc, &buf, 1, 1, 0);
+
+    init_stack(tc, &stack);
+    if (graphs) {
+        MVM_string_ci_init(tc, &ci, s, 0, 0);
+        while (grab_from_stack(tc, &ci, &stack, "key"));
+    }
+
+    for (level = 0; level < 3; level++) {
+        MVMint64 pos;
+        if (!level_dir[level] && level == 2)
+            continue;
+        for (pos = 0; pos <= stack.stack_top; pos++) {
+            MVMuint32 value = stack.keys[pos].a[level];
+            if (value == collation_zero)
+                continue;
+            collation_key_emit(tc, &buf,
+                level_dir[level] < 0 ? collation_value_max + 1 - value :
+                level_dir[level] > 0 ? value :
+                                       collation_key_disabled_marker, 3, 0);
+        }
+        /* The level separator. The comparison puts it against the other
+         * string's next value on the level under the level's direction, so
+         * it is the lowest value, and for a reversed level the highest; a
+         * string that is a prefix of another on a reversed level sorts after
+         * it there, as with descending order. */
+        collation_key_emit(tc, &buf,
+            level_dir[level] < 0 ? collation_value_max + 1 : 0, 3, 0);
+    }
+    cleanup_stack(tc, &stack);
+
+    /* Ties are broken by codepoint, then by length. */
+    if (level_dir[3]) {
+        MVMint32 reverse = level_dir[3] < 0;
+        MVM_string_ci_init(tc, &ci, s, 0, 0);
+        while (MVM_string_ci_has_more(tc, &ci))
+            collation_key_emit(tc, &buf, MVM_string_ci_get_codepoint(tc, &ci) + 1, 4, reverse);
+        collation_key_emit(tc, &buf, 0, 4, reverse);
+        collation_key_emit(tc, &buf, graphs, 6, reverse);
+    }
+
+    return MVM_string_ascii_from_buf_nocheck(tc, buf.digits, buf.used);
+}
+
+/* Whether a collation_mode leaves a level neither enabled nor reversed. */
+#define collation_level_disabled(collation_mode, level) \
+    (!((collation_mode) & (1 << ((level) * 2))) == !((collation_mode) & (2 << ((level) * 2))))
+/* Compares two strings under the given collation_mode. With COLLATION_DEBUG
+ * defined, it also checks that their collation keys compare the same way,
+ * which sorting by key relies on. That's skipped where the comparison has no
+ * consistent order for keys to follow: for the empty string without a
+ * quaternary level, which compares the same as anything, and with a disabled
+ * primary or secondary level (see MVM_unicode_string_collation_key). */
+MVMint64 MVM_unicode_string_compare(MVMThreadContext *tc, MVMString *a, MVMString *b,
+         MVMint64 collation_mode, MVMint64 lang_mode, MVMint64 country_mode) {
+    MVMint64 rtrn = collation_compare(tc, a, b, collation_mode, lang_mode, country_mode);
+#ifdef COLLATION_DEBUG
+    if (((MVM_string_graphs_nocheck(tc, a) && MVM_string_graphs_nocheck(tc, b))
+                || !collation_level_disabled(collation_mode, 3))
+            && !collation_level_disabled(collation_mode, 0)
+            && !collation_level_disabled(collation_mode, 1)) {
+        MVMString *key_a, *key_b;
+        MVMint64   key_rtrn;
+        MVMROOT(tc, b) {
+            key_a = MVM_unicode_string_collation_key(tc, a, collation_mode, lang_mode, country_mode);
+        }
+        MVMROOT(tc, key_a) {
+            key_b = MVM_unicode_string_collation_key(tc, b, collation_mode, lang_mode, country_mode);
+        }
+        key_rtrn = MVM_string_compare(tc, key_a, key_b);
+        if (key_rtrn != rtrn)
+            MVM_oops(tc, "Collation keys compare %"PRIi64" but the strings compare %"PRIi64" with collation_mode %"PRIi64,
+                key_rtrn, rtrn, collation_mode);
+    }
+#endif
+    return rtrn;
+}
+
 /* Looks up a codepoint by name. Lazily constructs a hash. */
 MVMGrapheme32 MVM_unicode_lookup_by_name(MVMThreadContext *tc, MVMString *name) {
     char *cname = MVM_string_utf8_encode_C_string(tc, name);
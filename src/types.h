@@ -6,10 +6,13 @@ typedef struct MVMArgProcContext MVMArgProcContext;
 typedef struct MVMArgs MVMArgs;
 typedef struct MVMArray MVMArray;
 typedef struct MVMArrayBody MVMArrayBody;
+typedef struct MVMArrayMapping MVMArrayMapping;
 typedef struct MVMArrayREPRData MVMArrayREPRData;
 typedef struct MVMAsyncTask MVMAsyncTask;
 typedef struct MVMAsyncTaskBody MVMAsyncTaskBody;
 typedef struct MVMAsyncTaskOps MVMAsyncTaskOps;
+typedef struct MVMEventLoop MVMEventLoop;
+typedef struct MVMTimerWheel MVMTimerWheel;
 typedef struct MVMAttributeIdentifier MVMAttributeIdentifier;
 typedef struct MVMBoolificationSpec MVMBoolificationSpec;
 typedef struct MVMBootTypes MVMBootTypes;
@@ -220,6 +223,7 @@ typedef struct MVMString MVMString;
 typedef struct MVMStringBody MVMStringBody;
 typedef struct MVMStringConsts MVMStringConsts;
 typedef struct MVMStringStrand MVMStringStrand;
+typedef struct MVMStringSearchNeedle MVMStringSearchNeedle;
 typedef struct MVMGraphemeIter MVMGraphemeIter;
 typedef struct MVMCodepointIter MVMCodepointIter;
 typedef struct MVMThread MVMThread;
@@ -336,3 +340,8 @@ typedef struct MVMTracked MVMTracked;
 typedef struct MVMTrackedBody MVMTrackedBody;
 typedef struct MVMStat MVMStat;
 typedef struct MVMStatBody MVMStatBody;
+typedef struct MVMConcHash MVMConcHash;
+typedef struct MVMConcHashBody MVMConcHashBody;
+typedef struct MVMConcHashStripe MVMConcHashStripe;
+typedef struct MVMConcArray MVMConcArray;
+typedef struct MVMConcArrayBody MVMConcArrayBody;
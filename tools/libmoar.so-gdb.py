@@ -304,6 +304,8 @@ def init_repr_types_and_structs():
     _ri("MVMCapture")
     _ri("MVMTracked")
     _ri("MVMStat")
+    _ri("ConcHash")
+    _ri("ConcArray")
 
     print(f"Registered {len(repr_infos)} REPRs.")
     if len(repr_errors):